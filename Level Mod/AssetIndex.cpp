@@ -0,0 +1,156 @@
+/**
+ * AssetIndex.cpp
+ *
+ * Description:
+ *    An index of the files in a mod's folder. LevelImporter, IniReader and
+ *    SetupHelpers all look up level files, texture packs, splines and SET
+ *    files through this index instead of each scanning the mod folder.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "AssetIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+AssetIndex::AssetIndex(const char* modFolderPath) {
+	std::filesystem::path modFolder(modFolderPath);
+	folderPaths[(int)AssetFolder::ModRoot] = modFolder;
+	folderPaths[(int)AssetFolder::GdPC] = modFolder / "gd_PC";
+	folderPaths[(int)AssetFolder::PRS] = modFolder / "gd_PC" / "PRS";
+	folderPaths[(int)AssetFolder::Paths] = modFolder / "gd_PC" / "Paths";
+	refresh();
+}
+
+void AssetIndex::refresh() {
+	entries.clear();
+	entriesByName.clear();
+	entriesByExtension.clear();
+	setFiles.clear();
+	indexFolder(AssetFolder::ModRoot);
+	indexFolder(AssetFolder::GdPC);
+	indexFolder(AssetFolder::PRS);
+	indexFolder(AssetFolder::Paths);
+	printDebug("Indexed " + std::to_string(entries.size()) + " mod file(s).");
+}
+
+const std::filesystem::path& AssetIndex::getFolderPath(AssetFolder folder) const {
+	return folderPaths[(int)folder];
+}
+
+const AssetEntry* AssetIndex::findFirst(AssetFolder folder, const std::string& extension) const {
+	auto it = entriesByExtension.find(makeKey(folder, extension));
+	if (it == entriesByExtension.end() || it->second.empty()) {
+		return nullptr;
+	}
+	return &entries[it->second.front()];
+}
+
+std::vector<const AssetEntry*> AssetIndex::findAll(AssetFolder folder, const std::string& extension) const {
+	std::vector<const AssetEntry*> found;
+	auto it = entriesByExtension.find(makeKey(folder, extension));
+	if (it != entriesByExtension.end()) {
+		for (size_t entryIndex : it->second) {
+			found.push_back(&entries[entryIndex]);
+		}
+	}
+	return found;
+}
+
+const AssetEntry* AssetIndex::find(AssetFolder folder, const std::string& fileName) const {
+	auto it = entriesByName.find(makeKey(folder, fileName));
+	if (it == entriesByName.end()) {
+		return nullptr;
+	}
+	return &entries[it->second];
+}
+
+const AssetEntry* AssetIndex::findSetFile(LevelIDs levelID, char type) const {
+	auto it = setFiles.find(levelID * 256 + std::tolower(type));
+	if (it == setFiles.end()) {
+		return nullptr;
+	}
+	return &entries[it->second];
+}
+
+void AssetIndex::indexFolder(AssetFolder folder) {
+	std::error_code error;
+	std::filesystem::directory_iterator iterator(folderPaths[(int)folder], error);
+	if (error) {
+		return;
+	}
+	auto toLower = [](std::string value) {
+		std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+		return value;
+	};
+	for (const auto& file : iterator) {
+		if (!file.is_regular_file(error)) {
+			continue;
+		}
+		const std::filesystem::path& filePath = file.path();
+		AssetEntry entry;
+		entry.path = filePath;
+		entry.folder = folder;
+		entry.modifiedTime = file.last_write_time(error);
+		entry.size = file.file_size(error);
+		entry.fileName = toLower(filePath.filename().string());
+		entry.stem = toLower(filePath.stem().string());
+		entry.extension = toLower(filePath.extension().string());
+		if (!entry.extension.empty()) {
+			entry.extension.erase(0, 1);
+		}
+		size_t entryIndex = entries.size();
+		entriesByName.emplace(makeKey(folder, entry.fileName), entryIndex);
+		entriesByExtension[makeKey(folder, entry.extension)].push_back(entryIndex);
+		entries.push_back(std::move(entry));
+		if (folder == AssetFolder::GdPC) {
+			indexSetFile(entryIndex);
+		}
+	}
+}
+
+void AssetIndex::indexSetFile(size_t entryIndex) {
+	// SET files are named "set" + level ID + '_' + type, e.g. set0013_s.bin.
+	const AssetEntry& entry = entries[entryIndex];
+	const std::string& stem = entry.stem;
+	if (entry.extension != "bin" || stem.rfind("set", 0) != 0) {
+		return;
+	}
+	size_t digitsEnd = stem.find_first_not_of("0123456789", 3);
+	if (digitsEnd == 3 || digitsEnd == std::string::npos
+			|| digitsEnd > 7 || digitsEnd + 2 != stem.size()
+			|| stem[digitsEnd] != '_') {
+		return;
+	}
+	int levelID = std::stoi(stem.substr(3, digitsEnd - 3));
+	setFiles.emplace(levelID * 256 + stem[digitsEnd + 1], entryIndex);
+}
+
+std::string AssetIndex::makeKey(AssetFolder folder, const std::string& name) {
+	std::string key = name;
+	std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+	key.insert(key.begin(), (char)('0' + (int)folder));
+	return key;
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,93 @@
+#pragma once
+#include "pch.h"
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* The folders of a mod that My Level Mod reads assets from. */
+enum class AssetFolder {
+	ModRoot, // ~yourModFolder
+	GdPC,    // ~yourModFolder\gd_PC
+	PRS,     // ~yourModFolder\gd_PC\PRS
+	Paths    // ~yourModFolder\gd_PC\Paths
+};
+
+/* A file found in one of the mod's asset folders. */
+struct AssetEntry {
+	std::filesystem::path path;
+	AssetFolder folder;
+	// Lowercase file name, stem and extension (without the dot), used for
+	// case insensitive lookups.
+	std::string fileName;
+	std::string stem;
+	std::string extension;
+	std::filesystem::file_time_type modifiedTime;
+	uintmax_t size;
+};
+
+/**
+ * An index of every file in a mod's asset folders. The folders are scanned
+ * once when the index is built, and again only when refresh() is called, so
+ * level imports never walk the mod folder themselves.
+ */
+class AssetIndex {
+	public:
+		AssetIndex(const char* modFolderPath);
+
+		/** Rescans the mod's asset folders. */
+		void refresh();
+
+		/** Returns the full path of one of the mod's asset folders. */
+		const std::filesystem::path& getFolderPath(AssetFolder folder) const;
+
+		/**
+		 * Returns the first file in a folder with the given extension, in
+		 * directory order, or nullptr if there is none.
+		 *
+		 * @param [folder] - The folder to search.
+		 * @param [extension] - The extension to look for, without the dot.
+		 */
+		const AssetEntry* findFirst(
+			AssetFolder folder,
+			const std::string& extension
+		) const;
+
+		/**
+		 * Returns every file in a folder with the given extension, in
+		 * directory order.
+		 */
+		std::vector<const AssetEntry*> findAll(
+			AssetFolder folder,
+			const std::string& extension
+		) const;
+
+		/**
+		 * Returns the file in a folder with the given file name, or nullptr
+		 * if there is none. The comparison ignores case.
+		 */
+		const AssetEntry* find(
+			AssetFolder folder,
+			const std::string& fileName
+		) const;
+
+		/**
+		 * Returns the SET file of a level, or nullptr if there is none.
+		 *
+		 * @param [levelID] - The level the SET file belongs to.
+		 * @param [type] - The type of SET file, 's' or 'u'.
+		 */
+		const AssetEntry* findSetFile(LevelIDs levelID, char type) const;
+
+	private:
+		std::filesystem::path folderPaths[4];
+		std::vector<AssetEntry> entries;
+		// Lookup tables into entries, keyed by folder and lowercase name.
+		std::unordered_map<std::string, size_t> entriesByName;
+		std::unordered_map<std::string, std::vector<size_t>> entriesByExtension;
+		// Keyed by level ID * 256 + SET file type.
+		std::unordered_map<int, size_t> setFiles;
+		void indexFolder(AssetFolder folder);
+		void indexSetFile(size_t entryIndex);
+		static std::string makeKey(AssetFolder folder, const std::string& name);
+};
@@ -0,0 +1,34 @@
+/**
+ * DataDllSymbolTable.cpp
+ *
+ * Description:
+ *    Looks up symbols in the game's data DLL, kept apart from the land table
+ *    registry so the registry can be tested without the game.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "DataDllSymbolTable.h"
+
+void* DataDllSymbolTable::findSymbol(const std::string& name) const {
+	return (void*)GetProcAddress(**datadllhandle, name.c_str());
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,10 @@
+#pragma once
+#include "pch.h"
+#include "SymbolTable.h"
+#include <string>
+
+/** The exports of Sonic Adventure 2's data DLL. */
+class DataDllSymbolTable : public SymbolTable {
+	public:
+		void* findSymbol(const std::string& name) const override;
+};
@@ -0,0 +1,64 @@
+/**
+ * ImportRegistry.cpp
+ *
+ * Description:
+ *    Keeps the import requests and finds the ones for the level being
+ *    loaded, without copying them.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "ImportRegistry.h"
+
+static const std::vector<size_t> NO_REQUESTS;
+
+size_t ImportRegistry::add(ImportRequest&& request) {
+	size_t index = requests.size();
+	if (request.levelID != LevelIDs_Invalid) {
+		requestsByLevel[request.levelID].push_back(index);
+	} else {
+		chaoGardenRequests.push_back(index);
+	}
+	requests.push_back(std::move(request));
+	return index;
+}
+
+const ImportRequest& ImportRegistry::get(size_t index) const {
+	return requests[index];
+}
+
+const std::vector<size_t>& ImportRegistry::findLevelRequests(LevelIDs levelID) const {
+	auto it = requestsByLevel.find(levelID);
+	return it == requestsByLevel.end() ? NO_REQUESTS : it->second;
+}
+
+const std::vector<size_t>& ImportRegistry::getChaoGardenRequests() const {
+	return chaoGardenRequests;
+}
+
+const std::deque<ImportRequest>& ImportRegistry::getRequests() const {
+	return requests;
+}
+
+size_t ImportRegistry::size() const {
+	return requests.size();
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,39 @@
+#pragma once
+#include "pch.h"
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Every imported level, indexed by level ID so a level load only looks at
+ * the requests for that level. Requests are moved in and never move again,
+ * so their index and address stay valid until exit.
+ */
+class ImportRegistry {
+	public:
+		/**
+		 * Moves a request into the registry and returns its index. Requests
+		 * with no level ID are chao garden requests.
+		 */
+		size_t add(ImportRequest&& request);
+
+		/* Returns the request at the given index. */
+		const ImportRequest& get(size_t index) const;
+
+		/* Returns the indexes of a level's requests, in the order added. */
+		const std::vector<size_t>& findLevelRequests(LevelIDs levelID) const;
+
+		/* Returns the indexes of the requests loaded with the chao world. */
+		const std::vector<size_t>& getChaoGardenRequests() const;
+
+		/* Every request, in the order added. */
+		const std::deque<ImportRequest>& getRequests() const;
+
+		size_t size() const;
+
+	private:
+		std::deque<ImportRequest> requests;
+		std::unordered_map<LevelIDs, std::vector<size_t>> requestsByLevel;
+		// Requests with no level ID, loaded with the chao world.
+		std::vector<size_t> chaoGardenRequests;
+};
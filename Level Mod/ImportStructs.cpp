@@ -9,6 +9,15 @@ std::string removeFileExtension(std::string fileName) {
 	return fileNameCopy;
 }
 
+uint64_t hashContents(const char* data, size_t size) {
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= (unsigned char)data[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
 void printDebug(std::string message) {
 	PrintDebug(("[My Level Mod] " + message).c_str());
 }
@@ -21,4 +30,12 @@ void showWarning(std::string message) {
 		"[My Level Mod] warning", // The title of the window
 		MB_OK | MB_ICONWARNING    // Buttons + Warning Icon
 	);
+}
+
+void showWarning(std::string message, bool show) {
+	if (show) {
+		showWarning(message);
+	} else {
+		printDebug(message);
+	}
 }
\ No newline at end of file
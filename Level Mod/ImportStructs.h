@@ -1,4 +1,6 @@
 #include "pch.h"
+#include <cstdint>
+#include <memory>
 #include <vector>
 #define DISABLED_PLANE -1.666f
 
@@ -11,8 +13,13 @@ struct LevelOptions {
 	float simpleDeathPlane = DISABLED_PLANE;
 	// The names of the ini files to load splines from.
 	std::vector<std::string> splineFileNames;
+	// Derive the splines' distances and rotations from their positions on
+	// load, instead of trusting the values in their files.
+	bool recomputeSplineMetrics = false;
 };
 
+class LevelOptionsIndex;
+
 /*
   The data necessary to import a level. For My Level Mod, this data is stored
   in level_options.ini. All resources are dynamically loaded on level init.
@@ -31,6 +38,11 @@ struct ImportRequest {
 	std::string pakFileName = std::string();
 	// The My Level Mod features to enable for this level. Optional.
 	LevelOptions levelOptions;
+	// Requests read from level_options.ini only have their levelID and
+	// landTableName at first. The rest of their section is parsed the first
+	// time the level is needed, through this index. nullptr otherwise.
+	std::shared_ptr<LevelOptionsIndex> optionsIndex;
+	size_t optionsSection = 0;
 };
 
 /*** Shared Functions ***/
@@ -38,6 +50,9 @@ struct ImportRequest {
 /* Returns a copy of the given string without a file extension. */
 std::string removeFileExtension(std::string fileName);
 
+/* 64-bit FNV-1a of the given bytes, used to tell files apart by contents. */
+uint64_t hashContents(const char* data, size_t size);
+
 /*
   Saves debug information in your mod loader's debug file. Enable "FILE" in the
   mod loader's debug menu to see messages.
@@ -49,3 +64,10 @@ void printDebug(std::string message);
   user.
 */
 void showWarning(std::string message);
+
+/*
+  Displays a warning like showWarning if show is true, otherwise only saves it
+  in the debug file. Background threads pass false, as a dialog would block
+  them.
+*/
+void showWarning(std::string message, bool show);
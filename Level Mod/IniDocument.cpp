@@ -0,0 +1,232 @@
+/**
+ * IniDocument.cpp
+ *
+ * Description:
+ *    A zero-copy ini file parser, used for both level_options.ini and spline
+ *    files. Lines and delimiters are found 16 bytes at a time with SSE2.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "IniDocument.h"
+#include <cstring>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define INI_USE_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+const IniEntry* IniSection::find(std::string_view key) const {
+	for (const IniEntry& entry : entries) {
+		if (entry.key == key) {
+			return &entry;
+		}
+	}
+	return nullptr;
+}
+
+bool IniSection::hasKey(std::string_view key) const {
+	return find(key) != nullptr;
+}
+
+std::string_view IniSection::getValue(std::string_view key, std::string_view defaultValue) const {
+	const IniEntry* entry = find(key);
+	return entry == nullptr ? defaultValue : entry->value;
+}
+
+IniDocument::IniDocument(const std::string& path) {
+	this->file = std::make_unique<MappedFile>(path);
+	addSection(std::string_view(), 0);
+	if (file->isOpen()) {
+		parse(file->data(), file->data() + file->size());
+	}
+}
+
+IniDocument::IniDocument(const char* data, size_t size) {
+	addSection(std::string_view(), 0);
+	parse(data, data + size);
+}
+
+bool IniDocument::isOpen() const {
+	return file == nullptr || file->isOpen();
+}
+
+const std::vector<IniSection>& IniDocument::getSections() const {
+	return sections;
+}
+
+const IniSection* IniDocument::findSection(std::string_view name) const {
+	auto it = sectionIndex.find(name);
+	return it == sectionIndex.end() ? nullptr : &sections[it->second];
+}
+
+void IniDocument::parse(const char* begin, const char* end) {
+	size_t section = 0;
+	size_t lineNumber = 0;
+	const char* lineStart = begin;
+	const char* blockStart = begin;
+	while (lineStart < end) {
+		const char* lineEnd = findByte(lineStart, end, '\n');
+		const char* currentLine = lineStart;
+		std::string_view line(lineStart, lineEnd - lineStart);
+		lineNumber++;
+
+		// Only lines with an escape need to be copied, everything else is
+		// cut at its comment and used in place.
+		size_t equals = std::string_view::npos;
+		const char* special = findAny(lineStart, lineEnd, '=', ';', '\\');
+		if (special != lineEnd && *special == '=') {
+			equals = special - lineStart;
+			special = findAny(special + 1, lineEnd, ';', '\\', '\\');
+		}
+		if (special != lineEnd && *special == '\\') {
+			line = unescape(line, equals);
+		} else if (special != lineEnd) {
+			line = line.substr(0, special - lineStart);
+		}
+		lineStart = lineEnd == end ? end : lineEnd + 1;
+
+		std::string_view trimmed = trim(line);
+		if (trimmed.empty()) {
+			continue;
+		}
+		size_t closingBracket = trimmed.find(']');
+		if (trimmed.front() == '[' && closingBracket != std::string_view::npos) {
+			sections[section].blocks.emplace_back(blockStart, currentLine - blockStart);
+			section = addSection(
+				trim(trimmed.substr(1, closingBracket - 1)),
+				lineNumber
+			);
+			blockStart = lineStart;
+			continue;
+		}
+		IniEntry entry;
+		entry.key = trim(line.substr(0, equals));
+		entry.value = equals == std::string_view::npos
+			? std::string_view()
+			: trim(line.substr(equals + 1));
+		entry.lineNumber = lineNumber;
+		if (!sections[section].hasKey(entry.key)) {
+			sections[section].entries.push_back(entry);
+		}
+	}
+	sections[section].blocks.emplace_back(blockStart, end - blockStart);
+}
+
+size_t IniDocument::addSection(std::string_view name, size_t lineNumber) {
+	auto [it, added] = sectionIndex.emplace(name, sections.size());
+	if (added) {
+		sections.push_back(IniSection{ name, lineNumber, {}, {} });
+	}
+	return it->second;
+}
+
+std::string_view IniDocument::unescape(std::string_view line, size_t& equals) {
+	std::string& text = unescapedLines.emplace_back();
+	equals = std::string_view::npos;
+	for (size_t i = 0; i < line.size() && line[i] != ';'; i++) {
+		if (line[i] == '\\') {
+			// Like IniFile, a backslash ending the line is kept. The line's
+			// '\r' is still here in files with Windows line endings.
+			if (i + 1 == line.size() || (i + 2 == line.size() && line[i + 1] == '\r')) {
+				text += '\\';
+				continue;
+			}
+			i++;
+			text += line[i] == 'n' ? '\n' : line[i] == 'r' ? '\r' : line[i];
+			continue;
+		}
+		if (line[i] == '=' && equals == std::string_view::npos) {
+			equals = text.size();
+		}
+		text += line[i];
+	}
+	return text;
+}
+
+std::string_view IniDocument::trim(std::string_view value) {
+	const char* whitespace = " \t\r";
+	size_t start = value.find_first_not_of(whitespace);
+	if (start == std::string_view::npos) {
+		return std::string_view();
+	}
+	size_t end = value.find_last_not_of(whitespace);
+	return value.substr(start, end - start + 1);
+}
+
+#ifdef INI_USE_SSE2
+static unsigned int firstSetBit(unsigned int mask) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+const char* IniDocument::findByte(const char* begin, const char* end, char c) {
+#ifdef INI_USE_SSE2
+	const __m128i needle = _mm_set1_epi8(c);
+	for (; end - begin >= 16; begin += 16) {
+		__m128i block = _mm_loadu_si128((const __m128i*)begin);
+		int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+		if (mask != 0) {
+			return begin + firstSetBit(mask);
+		}
+	}
+#endif
+	const char* found = (const char*)std::memchr(begin, c, end - begin);
+	return found == nullptr ? end : found;
+}
+
+const char* IniDocument::findAny(const char* begin, const char* end, char a, char b, char c) {
+#ifdef INI_USE_SSE2
+	const __m128i needleA = _mm_set1_epi8(a);
+	const __m128i needleB = _mm_set1_epi8(b);
+	const __m128i needleC = _mm_set1_epi8(c);
+	for (; end - begin >= 16; begin += 16) {
+		__m128i block = _mm_loadu_si128((const __m128i*)begin);
+		__m128i matches = _mm_or_si128(
+			_mm_or_si128(
+				_mm_cmpeq_epi8(block, needleA),
+				_mm_cmpeq_epi8(block, needleB)
+			),
+			_mm_cmpeq_epi8(block, needleC)
+		);
+		int mask = _mm_movemask_epi8(matches);
+		if (mask != 0) {
+			return begin + firstSetBit(mask);
+		}
+	}
+#endif
+	for (; begin < end; begin++) {
+		if (*begin == a || *begin == b || *begin == c) {
+			return begin;
+		}
+	}
+	return end;
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,92 @@
+#pragma once
+#include "pch.h"
+#include "MappedFile.h"
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/* A key=value line. The key and value point into the IniDocument. */
+struct IniEntry {
+	std::string_view key;
+	std::string_view value;
+	size_t lineNumber;
+};
+
+/* A [group] of an ini file. The global group has an empty name. */
+struct IniSection {
+	std::string_view name;
+	size_t lineNumber;
+	std::vector<IniEntry> entries;
+	// The raw text of each part of the file in this section, after its
+	// [name] line. Repeated groups have more than one part.
+	std::vector<std::string_view> blocks;
+
+	/* Returns the first entry with the given key, or nullptr. */
+	const IniEntry* find(std::string_view key) const;
+	bool hasKey(std::string_view key) const;
+	std::string_view getValue(
+		std::string_view key,
+		std::string_view defaultValue = std::string_view()
+	) const;
+};
+
+/**
+ * An ini file, read the same way as the mod loader's IniFile. The file is
+ * memory mapped and parsed once; section names, keys and values are views
+ * into the mapped memory, so they are only valid while the document is.
+ *
+ * Like IniFile, ';' starts a comment anywhere on a line, '\' escapes the
+ * next character ("\n" and "\r" being newlines), the first value of a
+ * repeated key wins, and repeated groups are merged. Unlike IniFile, spaces
+ * around names, keys and values are ignored.
+ */
+class IniDocument {
+	public:
+		IniDocument(const std::string& path);
+		/*
+		  Parses ini text held in memory instead of a file. The memory must
+		  outlive the document.
+		*/
+		IniDocument(const char* data, size_t size);
+		IniDocument(const IniDocument&) = delete;
+		IniDocument& operator=(const IniDocument&) = delete;
+
+		/** Whether the file could be read. Empty files can't be. */
+		bool isOpen() const;
+		/* Sections in file order. The global section is always first. */
+		const std::vector<IniSection>& getSections() const;
+		/* Returns the section with the given name, or nullptr. */
+		const IniSection* findSection(std::string_view name) const;
+
+	private:
+		// nullptr if the document was parsed from memory.
+		std::unique_ptr<MappedFile> file;
+		std::vector<IniSection> sections;
+		std::unordered_map<std::string_view, size_t> sectionIndex;
+		// Lines with escapes can't point into the file, so their unescaped
+		// text is kept here. A deque never moves its strings.
+		std::deque<std::string> unescapedLines;
+
+		void parse(const char* begin, const char* end);
+		/* Returns the index of the named section, adding it if needed. */
+		size_t addSection(std::string_view name, size_t lineNumber);
+		/*
+		  Copies a line with its escapes resolved, up to its comment, and
+		  finds its first unescaped '='.
+		*/
+		std::string_view unescape(std::string_view line, size_t& equals);
+		static std::string_view trim(std::string_view value);
+		/* Returns the first c in [begin, end), or end. */
+		static const char* findByte(const char* begin, const char* end, char c);
+		/* Returns the first a, b or c in [begin, end), or end. */
+		static const char* findAny(
+			const char* begin,
+			const char* end,
+			char a,
+			char b,
+			char c
+		);
+};
@@ -14,288 +14,529 @@
  */
 
 #include "pch.h"
-#include "IniFile.hpp"
+#include "IniDocument.h"
 #include "IniReader.h"
-#include "SetupHelpers.h"
+#include "LevelOptionsIndex.h"
+#include "OptionSchema.h"
+#include "OptionsCache.h"
+#include "SplineMetrics.h"
+#include "SplineTessellator.h"
+#include "ValueParser.h"
 #include <fstream>
 #include <string>
 #include <sstream>
 #include <filesystem>
 #include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
 
-IniReader::IniReader(const char* modFolderPath) {
+IniReader::IniReader(const char* modFolderPath, const AssetIndex& assetIndex) {
 	this->optionsPath = _strdup((std::string(modFolderPath) +
 			"\\level_options.ini").c_str());
-	this->gdPCPath = _strdup((std::string(modFolderPath) + "\\gd_PC").c_str());
+	this->assetIndex = &assetIndex;
 }
 
 /**
- * Parses through the level_options.ini file to find out which levels to import
- * and which level features should be enabled. It is important to note that
- * level features only work for levels imported by level id.
+ * Indexes the level_options.ini file to find out which levels to import. Only
+ * each level's level_id, land_table_name and spawn and victory coordinates
+ * are read here, as positions must be registered before any level loads; the
+ * rest of its section is parsed by parseLevelSection to rebuild the options
+ * cache, and its level files are found the first time the level is needed.
+ * It is important to note that level features only work for levels imported
+ * by level id. Fully parsed options are cached, and reused until
+ * level_options.ini changes.
  */
 std::vector<ImportRequest> IniReader::readLevelOptions() {
 	printDebug("");
-	printDebug("Reading options from \"level_options.ini.\"");
-	IniFile* iniFile = new IniFile(optionsPath);
-
-	auto printTabbed = [](std::string message) {
-		printDebug("  " + message);
-	};
-
-	auto printWarning = [](std::string message) {
-		showWarning("Warning: " + message);
-	};
+	std::vector<ImportRequest> requests;
+	if (readOptionsCache(optionsPath, requests)) {
+		printDebug("Using cached options for \"level_options.ini.\" " +
+			std::to_string(requests.size()) + " custom level(s) found.");
+		return requests;
+	}
+	printDebug("Indexing \"level_options.ini.\"");
+	IniDocument iniFile(optionsPath);
+	auto optionsIndex = std::make_shared<LevelOptionsIndex>(optionsPath);
 
 	bool hadFailedRequest = false;
-	std::vector<ImportRequest> requests;
-	for (auto it = iniFile->begin(); it != iniFile->end(); it++) {
-		if (it->first.empty()) {
+	for (const IniSection& iniGroup : iniFile.getSections()) {
+		if (iniGroup.name.empty()) {
 			continue;
 		}
-		printDebug("");
-		printDebug("Custom level [" + it->first + "] found:");
-		IniGroup* iniGroup = it->second;
 		ImportRequest request;
-		LevelOptions levelOptions;
-		if (iniGroup->hasKey("level_id")) {
-			try {
-				printTabbed("level_id=" + iniGroup->getString("level_id"));
-				request.levelID = 
-					(LevelIDs)iniGroup->getInt("level_id", LevelIDs_Invalid);
-			} catch (...) {
-				printWarning("Invalid level_id given: \"" +
-					iniGroup->getString("level_id") + "\"");
-			}
-		}
-		if (iniGroup->hasKey("land_table_name")) {
-			request.landTableName = iniGroup->getString("land_table_name");
-			printTabbed("land_table_name=" + request.landTableName);
-		}
-		if (iniGroup->hasKey("level_file_name")) {
-			request.levelFileName = iniGroup->getString("level_file_name");
-			printTabbed("level_file_name=" + request.levelFileName);
-		}
-		if (iniGroup->hasKey("pak_file_name")) {
-			request.pakFileName = iniGroup->getString("pak_file_name");
-			printTabbed("pak_file_name=" + request.pakFileName);
-		}
-		if (iniGroup->hasKey("spline_file_names")) {
-			levelOptions.splineFileNames = getTokens(
-				iniGroup->getString("spline_file_names")
-			);
-			printTabbed("spline_file_names=" +
-				iniGroup->getString("spline_file_names"));
-		}
-		if (iniGroup->hasKey("simple_death_plane")) {
-			try {
-				levelOptions.simpleDeathPlane = 
-					iniGroup->getFloat("simple_death_plane", DISABLED_PLANE);
-				printTabbed("simple_death_plane=" +
-					std::to_string(levelOptions.simpleDeathPlane));
-			} catch (...) {
-				std::string simpleDeathPlaneStr = iniGroup->getString("simple_death_plane") ;
-				std::transform(simpleDeathPlaneStr.begin(), simpleDeathPlaneStr.end(), simpleDeathPlaneStr.begin(), ::toupper);
-				if (simpleDeathPlaneStr != "OFF" && simpleDeathPlaneStr != "FALSE") {
-					printWarning("Invalid simple_death_plane given: " +
-						iniGroup->getString("simple_death_plane"));
-				}
-			}
-		}
-		std::string coordinates;
-		try {
-			coordinates = iniGroup->getString("spawn_coordinates", "0,0,0");
-			printTabbed("spawn_coordinates=" + coordinates);
-			levelOptions.startPosition = getPosition(coordinates);
-		}
-		catch (...) {
-			printWarning("Invalid spawn coordinates given: \"" + coordinates +
-				".\" Using 0, 0, 0 as default.");
+		std::string_view levelID = iniGroup.getValue("level_id");
+		ParseResult<int> levelIDResult = parseInt(levelID);
+		if (levelIDResult) {
+			request.levelID = (LevelIDs)levelIDResult.value;
 		}
-		try {
-			coordinates = iniGroup->getString("victory_coordinates", "0,0,0");
-			printTabbed("victory_coordinates=" + coordinates);
-			levelOptions.endPosition = getPosition(coordinates);
-		}
-		catch (...) {
-			printWarning("Invalid victory coordinates given: \"" +
-				coordinates + ".\" Using 0, 0, 0 as default.");
+		request.landTableName = iniGroup.getValue("land_table_name");
+		// Invalid coordinates are reported when the section is parsed.
+		for (const char* key : { "spawn_coordinates", "victory_coordinates" }) {
+			const OptionDescriptor& option = OPTION_SCHEMA[findOption(key)];
+			std::string_view value = iniGroup.getValue(key);
+			option.apply(value.empty() ? option.defaultValue : value, request);
 		}
 		if (request.levelID == LevelIDs_Invalid && request.landTableName.empty()) {
+			std::string reason = levelID.empty()
+				? std::string()
+				: " " + describeParseError("level_id", levelID, levelIDResult.error);
 			printDebug("");
-			printWarning("This level import does not have a level_id "
-				"or land_table_name set. Discarding import, please check your "
-				"level_options.ini file if this is a mistake.");
+			showWarning("Warning: The level import [" + std::string(iniGroup.name) +
+				"] does not have a level_id or land_table_name set." + reason +
+				" Discarding import, please check your level_options.ini file "
+				"if this is a mistake.");
+			optionsIndex->markWarning();
 			hadFailedRequest = true;
 			continue;
 		}
-		request.levelOptions = levelOptions;
+		std::string sectionText;
+		for (std::string_view block : iniGroup.blocks) {
+			sectionText.append(block);
+			sectionText += '\n';
+		}
+		request.optionsSection = optionsIndex->addSection(
+			std::string(iniGroup.name),
+			std::move(sectionText)
+		);
+		request.optionsIndex = optionsIndex;
 		requests.push_back(request);
 	}
 	if (requests.size() == 0 && !hadFailedRequest) {
-		printWarning("Could not find options file. Please redownload My Level Mod.");
+		showWarning("Warning: Could not find options file. Please redownload My Level Mod.");
 	}
-	printDebug("");
-	printDebug("Done reading options.");
-	delete iniFile;
+	// Sections are parsed once here for the cache, so the next launch can
+	// skip indexing, however few of the levels are played this time.
+	optionsIndex->writeCache();
+	printDebug(std::to_string(requests.size()) + " custom level(s) found. Their "
+		"files are found when they are first needed.");
 	return requests;
 }
 
+/**
+ * Parses a level_options.ini section's options into a request. Warnings are
+ * collected instead of shown, as this may run on a background thread.
+ */
+void IniReader::parseLevelSection(
+		const IniSection& iniGroup,
+		const std::string& name,
+		ImportRequest& request,
+		std::vector<std::string>& warnings) {
+	std::string log = "Custom level [" + name + "] options:";
+	uint32_t seenOptions = 0;
+	for (const IniEntry& entry : iniGroup.entries) {
+		int option = findOption(entry.key);
+		if (option == -1) {
+			warnings.push_back("Unknown option \"" + std::string(entry.key) +
+				"\" in [" + name + "], ignoring it.");
+			continue;
+		}
+		seenOptions |= 1u << option;
+		log += "\n  " + std::string(entry.key) + "=" + std::string(entry.value);
+		const char* error = OPTION_SCHEMA[option].apply(entry.value, request);
+		if (error != nullptr) {
+			warnings.push_back(describeParseError(entry.key, entry.value, error));
+		}
+	}
+	for (size_t i = 0; i < OPTION_COUNT; i++) {
+		const OptionDescriptor& option = OPTION_SCHEMA[i];
+		if ((seenOptions & (1u << i)) == 0 && option.defaultValue != nullptr) {
+			option.apply(option.defaultValue, request);
+		}
+	}
+	printDebug(log);
+}
+
 /**
  * Automatically detect and attempt to read all Spline files. This function
- * checks both the gd_PC folder and a "paths" folder for Spline files.
+ * checks both the gd_PC folder and a "paths" folder for Spline files, in ini
+ * or sa2path format.
+ *
+ * The files are found first, then taken from the spline pool at the same
+ * time on the worker pool, which only parses files whose contents no loaded
+ * level uses yet. Each pooled spline has its points in one block, or in its
+ * mapped .sa2path file, and is shared as is by every level using it. The
+ * array lists the splines in the order their files were found, so it is the
+ * same however the reads were scheduled.
  */
-LoopHead** IniReader::readSplines(std::vector<std::string> splineFileNames) {
-	std::vector<std::string> fileNamesCopy;
-	copy(
-		splineFileNames.begin(),
-		splineFileNames.end(),
-		std::back_inserter(fileNamesCopy)
-	);
-	boolean readAllFiles = splineFileNames.empty();
-	for (unsigned int i = 0; i < fileNamesCopy.size(); i++) {
-		fileNamesCopy[i] = removeFileExtension(fileNamesCopy[i]).append(".ini");
+LoopHead** IniReader::readSplines(
+		std::vector<std::string> splineFileNames,
+		bool recomputeMetrics,
+		LevelArena& arena,
+		WorkerPool& workerPool,
+		SplinePool& splinePool,
+		std::vector<std::shared_ptr<SharedSpline>>& sharedSplines,
+		bool showWarnings) {
+	// Names are matched against the whole file stem, ignoring case and an
+	// .ini or .sa2path extension, so "rail.v1" and "rail.v2" stay apart.
+	std::vector<std::string> normalizedNames;
+	for (const std::string& splineFileName : splineFileNames) {
+		normalizedNames.push_back(normalizeSplineName(splineFileName));
 	}
-	std::vector<LoopHead*> splines;
-	std::string pathToPathsFolder = std::string(gdPCPath) + "\\Paths";
+	boolean readAllFiles = splineFileNames.empty();
+	std::vector<const AssetEntry*> splineFiles;
 
-	/* 
-	  Reads a spline from a given file if it is present in a given set of file
-	  names.
-	*/
-	auto readSplineFile = [&splines](std::string filePath, std::vector<std::string> fileNames) mutable {
-		for (std::string splineFileName : fileNames) {
-			if (filePath.find(splineFileName) != std::string::npos) {
-				printDebug("Spline file \"" + filePath + "\" found.");
-				LoopHead* spline = readSpline(filePath);
-				if (spline != nullptr) {
-					splines.push_back(spline);
-				}
+	// Attempt to find the given spline file names in the mod's gdPC folder,
+	// then in the mod's Paths folder. Binary splines with an ini file are
+	// handled through the ini file, and are matched by the name of their ini
+	// file.
+	for (AssetFolder folder : { AssetFolder::GdPC, AssetFolder::Paths }) {
+		std::vector<const AssetEntry*> files = assetIndex->findAll(folder, "ini");
+		for (const AssetEntry* file : assetIndex->findAll(folder, SPLINE_EXTENSION)) {
+			if (assetIndex->find(folder, file->stem + ".ini") == nullptr) {
+				files.push_back(file);
 			}
 		}
-	};
-
-	/* Reads a spline from a given file. Only use if there is one level. */
-	auto readAllSplineFiles = [&splines](std::string filePath) mutable {
-		if (filePath.find(".ini") != std::string::npos) {
-			printDebug("Spline file \"" + filePath + "\" found.");
-			LoopHead* spline = readSpline(filePath);
-			if (spline != nullptr) {
-				splines.push_back(spline);
+		for (const AssetEntry* file : files) {
+			if (readAllFiles || std::find(normalizedNames.begin(),
+					normalizedNames.end(), file->stem) != normalizedNames.end()) {
+				splineFiles.push_back(file);
 			}
 		}
-	};
-
-	// Attempt to find the given spline file names in the mod's gdPC folder.
-	for (const auto& file : std::filesystem::directory_iterator(gdPCPath)) {
-		if (readAllFiles) {
-			readAllSplineFiles(file.path().string());
-		} else {
-			readSplineFile(file.path().string(), fileNamesCopy);
-		}
 	}
 
-	// Attempt to find the given spline file names in the mod's Paths folder.
-	if (std::filesystem::exists(pathToPathsFolder)) {
-		for (const auto& file :
-			std::filesystem::directory_iterator(pathToPathsFolder)) {
-			if (readAllFiles) {
-				readAllSplineFiles(file.path().string());
-			} else {
-				readSplineFile(file.path().string(), fileNamesCopy);
-			}
+	std::vector<std::shared_ptr<SharedSpline>> fileSplines(splineFiles.size());
+	workerPool.run(splineFiles.size(), [&](size_t i) {
+		const AssetEntry* file = splineFiles[i];
+		printDebug("Spline file \"" + file->path.string() + "\" found.");
+		fileSplines[i] = splinePool.get(*file, recomputeMetrics,
+			[this, file, recomputeMetrics, showWarnings](LevelArena& splineArena) {
+				return loadSplineFile(file, recomputeMetrics, splineArena, showWarnings);
+			});
+	});
+
+	// Files with the same contents share a spline, which is only added once.
+	std::vector<LoopHead*> splines;
+	for (std::shared_ptr<SharedSpline>& fileSpline : fileSplines) {
+		if (fileSpline == nullptr || fileSpline->spline == nullptr) {
+			continue;
+		}
+		if (std::find(splines.begin(), splines.end(), fileSpline->spline) == splines.end()) {
+			splines.push_back(fileSpline->spline);
+			sharedSplines.push_back(std::move(fileSpline));
 		}
 	}
 	if (splines.size() != 0) {
 		printDebug(std::to_string(splines.size()) + " rail spline(s) "
 			"successfully added.");
-		const int size = splines.size() + 1;
-		LoopHead** splinesArray = new LoopHead*[size];
+		LoopHead** splinesArray = arena.allocate<LoopHead*>(splines.size() + 1);
 		std::copy(splines.begin(), splines.end(), splinesArray);
-		splinesArray[size - 1] = nullptr;
 		return splinesArray;
 	}
 	showWarning("Warning: Spline loading was called, but no splines were "
 		"successfully added. Double check the file names, skipping spline "
-		"read.");
+		"read.", showWarnings);
 	return nullptr;
 }
 
+/* Lowercases a spline file name and removes an .ini or .sa2path extension. */
+std::string IniReader::normalizeSplineName(const std::string& fileName) {
+	std::string name = fileName;
+	std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+	for (std::string extension : { ".ini", "." SPLINE_EXTENSION }) {
+		if (name.size() > extension.size() && name.compare(
+				name.size() - extension.size(), extension.size(), extension) == 0) {
+			name.resize(name.size() - extension.size());
+			break;
+		}
+	}
+	return name;
+}
+
 /**
  * Attempts to read and generate a LoopHead object from a given Spline file.
  * Returns nullptr if something goes wrong.
  *
  * @param [filePath] - The full file path to your ini file.
+ * @param [arena] - The arena that owns the spline's memory.
+ * @param [showWarnings] - Whether to show a dialog if the spline is invalid,
+ *     rather than only logging it.
  * 
  * Based on MainMemory's ProcessPathList function at
  * https://github.com/X-Hax/sa2-mod-loader/blob/master/SA2ModLoader/EXEData.cpp
  */
-LoopHead* IniReader::readSpline(std::string filePath) {
-	IniFile* splineFile = new IniFile(filePath);
-	IniGroup* iniGroup;
-	std::vector<LoopPoint> points;
-	for (unsigned int i = 0; i < 9999; i++) {
-		std::string index = std::to_string(i);
-		if (!splineFile->hasGroup(index)) {
-			break;
+LoopHead* IniReader::readSpline(std::string filePath, LevelArena& arena, bool showWarnings) {
+	std::string error;
+	LoopHead* spline = parseSpline(filePath, arena, error);
+	if (spline == nullptr) {
+		showWarning("Warning: " + error + " Throwing away spline.", showWarnings);
+	}
+	return spline;
+}
+
+/**
+ * Parses a spline ini file. Points are written straight into the arena, in
+ * the order of their [index] group, up to the first missing index. Returns
+ * nullptr and sets error, including the line number, if the file is not a
+ * valid spline.
+ *
+ * A file with a "Density" header only lists control points, see
+ * tessellateSpline. Density points are generated per control point segment,
+ * and their distances and rotations are computed from their positions.
+ */
+LoopHead* IniReader::parseSpline(const std::string& filePath, LevelArena& arena, std::string& error) {
+	IniDocument iniFile(filePath);
+	if (!iniFile.isOpen()) {
+		error = "Could not read the spline found at " + filePath + ".";
+		return nullptr;
+	}
+	const std::vector<IniSection>& sections = iniFile.getSections();
+
+	// Every point has its own section, so the section count is an upper
+	// bound on the number of points.
+	size_t capacity = std::min<size_t>(sections.size() - 1, MAX_SPLINE_POINTS);
+	LoopPoint* points = arena.allocate<LoopPoint>(capacity);
+	std::vector<bool> hasPoint(capacity);
+
+	auto fail = [&](const IniEntry& entry, const char* reason) {
+		error = "The spline found at " + filePath + " has an invalid \"" +
+			std::string(entry.key) + "\" value \"" + std::string(entry.value) +
+			"\" on line " + std::to_string(entry.lineNumber) + " (" + reason + ").";
+		return nullptr;
+	};
+
+	// The global section holds the spline's header.
+	int16_t unknown = 1; // anonymous_0 must default to 1 in SA2 to work.
+	float totalDistance = 0;
+	uint32_t code = 0;
+	bool hasCode = false;
+	// Points per control point segment, or 0 if every point is listed.
+	int density = 0;
+	const IniEntry* densityEntry = nullptr;
+	for (const IniEntry& entry : sections[0].entries) {
+		if (entry.key == "Code") {
+			ParseResult<uint32_t> result = parseHex(entry.value);
+			if (!result) {
+				return fail(entry, result.error);
+			}
+			code = result.value;
+			hasCode = true;
+		} else if (entry.key == "TotalDistance") {
+			ParseResult<float> result = parseFloat(entry.value);
+			if (!result) {
+				return fail(entry, result.error);
+			}
+			totalDistance = result.value;
+		} else if (entry.key == "Unknown") {
+			ParseResult<int> result = parseInt(entry.value);
+			if (!result) {
+				return fail(entry, result.error);
+			}
+			unknown = (int16_t)result.value;
+		} else if (entry.key == "Density") {
+			ParseResult<int> result = parseInt(entry.value);
+			if (!result) {
+				return fail(entry, result.error);
+			}
+			// Bounded before any point count is multiplied out of it.
+			if (result.value < 1 || result.value > MAX_SPLINE_POINTS) {
+				return fail(entry, ("must be between 1 and " +
+					std::to_string(MAX_SPLINE_POINTS)).c_str());
+			}
+			density = result.value;
+			densityEntry = &entry;
 		}
-		iniGroup = splineFile->getGroup(index);
-		points.push_back({
-			(int16_t)iniGroup->getIntRadix("XRotation", 16),
-			(int16_t)iniGroup->getIntRadix("ZRotation", 16),
-			iniGroup->getFloat("Distance"),
-			getPosition(iniGroup->getString("Position", "0,0,0")),
-		});
 	}
-	iniGroup = splineFile->getGroup("");
-	LoopHead* spline = new LoopHead;
-	// anonymous_0 must default to 1 in SA2 to work.
-	spline->anonymous_0 = (int16_t)iniGroup->getInt("Unknown", 1);
-	spline->Count = (int16_t)points.size();
-	spline->TotalDistance = iniGroup->getFloat("TotalDistance");
-	spline->Points = new LoopPoint[spline->Count];
-	spline->Object = (ObjectFuncPtr)iniGroup->getIntRadix("Code", 16);
-	if (!iniGroup->hasKey("Code")) {
-		showWarning("Warning: The spline found at " + filePath + " is missing "
-			"the \"Code\" field. Did you forget to add it? Throwing away "
-			"spline.");
-		delete spline;
+	if (!hasCode) {
+		error = "The spline found at " + filePath + " is missing the \"Code\" "
+			"field. Did you forget to add it?";
 		return nullptr;
 	}
-	std::copy(points.begin(), points.end(), spline->Points);
-	delete splineFile;
+
+	for (size_t i = 1; i < sections.size(); i++) {
+		std::string_view name = sections[i].name;
+		size_t index = 0;
+		auto [end, result] = std::from_chars(name.data(), name.data() + name.size(), index);
+		if (result != std::errc() || end != name.data() + name.size()
+				|| index >= capacity) {
+			continue;
+		}
+		hasPoint[index] = true;
+		LoopPoint& point = points[index];
+		for (const IniEntry& entry : sections[i].entries) {
+			if (entry.key == "XRotation" || entry.key == "ZRotation") {
+				ParseResult<uint32_t> result = parseHex(entry.value);
+				if (!result) {
+					return fail(entry, result.error);
+				}
+				if (entry.key == "XRotation") {
+					point.XRot = (int16_t)result.value;
+				} else {
+					point.YRot = (int16_t)result.value;
+				}
+			} else if (entry.key == "Distance") {
+				ParseResult<float> result = parseFloat(entry.value);
+				if (!result) {
+					return fail(entry, result.error);
+				}
+				point.Distance = result.value;
+			} else if (entry.key == "Position") {
+				ParseResult<NJS_VECTOR> result = parsePosition(entry.value);
+				if (!result) {
+					return fail(entry, result.error);
+				}
+				point.Position = result.value;
+			}
+		}
+	}
+	size_t count = 0;
+	while (count < capacity && hasPoint[count]) {
+		count++;
+	}
+	// With a density, the listed points are only control points for the
+	// curve, and the rail's points are generated from them.
+	if (density > 0 && count >= 2) {
+		uint64_t tessellatedCount = getTessellatedPointCount(count, density);
+		if (tessellatedCount > MAX_SPLINE_POINTS) {
+			return fail(*densityEntry, ("makes " + std::to_string(tessellatedCount) +
+				" points, more than " + std::to_string(MAX_SPLINE_POINTS)).c_str());
+		}
+		LoopPoint* tessellatedPoints = arena.allocate<LoopPoint>((size_t)tessellatedCount);
+		tessellateSpline(points, count, density, tessellatedPoints);
+		points = tessellatedPoints;
+		count = (size_t)tessellatedCount;
+	}
+	LoopHead* spline = arena.allocate<LoopHead>();
+	spline->anonymous_0 = unknown;
+	spline->Count = (int16_t)count;
+	spline->TotalDistance = totalDistance;
+	spline->Points = points;
+	spline->Object = (ObjectFuncPtr)(uintptr_t)code;
+	if (density > 0) {
+		recomputeSplineMetrics(*spline);
+	}
 	return spline;
 }
 
-NJS_VECTOR IniReader::getPosition(std::string position) {
-	std::vector<std::string> tokens = getTokens(position);
-	float coords[3]{};
-	for (int i = 0; i < 3; i++) {
-		coords[i] = std::stof(tokens[i]);
+LoopHead* IniReader::loadSplineFile(const AssetEntry* file, bool recomputeMetrics, LevelArena& arena, bool showWarnings) const {
+	LoopHead* spline = nullptr;
+	if (file->extension == SPLINE_EXTENSION) {
+		spline = readBinarySpline(file->path, arena);
+	} else {
+		// Prefer a binary copy of the spline, as long as it was made from the
+		// ini's current contents. Times are not enough, as copying a mod can
+		// give an old binary copy a newer time than an edited ini.
+		const AssetEntry* binaryFile = assetIndex->find(
+			file->folder,
+			file->stem + "." + SPLINE_EXTENSION
+		);
+		uint64_t sourceHash;
+		if (binaryFile != nullptr && hashSourceFile(file->path, sourceHash)) {
+			spline = readBinarySpline(binaryFile->path, arena, &sourceHash);
+		}
+		if (spline == nullptr) {
+			spline = readSpline(file->path.string(), arena, showWarnings);
+		}
+	}
+	// Binary splines are mapped copy on write, so their files never change.
+	if (spline != nullptr && recomputeMetrics) {
+		recomputeSplineMetrics(*spline);
 	}
-	return NJS_VECTOR{ coords[0], coords[1], coords[2] };
+	return spline;
 }
 
-std::vector<std::string> IniReader::getTokens(std::string value) {
-	std::string valueCopy = value; // C++ 11 forces deep copy.
-	std::string::iterator end_pos = std::remove(
-		valueCopy.begin(),
-		valueCopy.end(),
-		' ');
-	valueCopy.erase(end_pos, valueCopy.end());
-	std::vector<std::string> tokens;
-	if (valueCopy.empty()) {
-		return tokens;
+/* Hashes an ini file's contents for comparison with BinarySplineHeader. */
+bool IniReader::hashSourceFile(const std::filesystem::path& filePath, uint64_t& hash) {
+	MappedFile file(filePath);
+	if (!file.isOpen()) {
+		return false;
 	}
-	std::stringstream ss(valueCopy);
-	std::string token;
-	while (!ss.eof()) {
-		std::getline(ss, token, ',');
-		tokens.push_back(token);
+	hash = hashContents(file.data(), file.size());
+	return true;
+}
+
+/**
+ * Reads a spline from a .sa2path file. The file is memory mapped and the
+ * spline's points are read straight from the mapped memory, without any
+ * parsing. The mapping lives until the arena is freed.
+ *
+ * @param [filePath] - The full file path to your sa2path file.
+ * @param [arena] - The arena that owns the spline and the mapped file.
+ * @param [sourceHash] - If given, the hash the file's source ini must have.
+ */
+LoopHead* IniReader::readBinarySpline(const std::filesystem::path& filePath, LevelArena& arena, const uint64_t* sourceHash) {
+	const MappedFile* file = arena.mapFile(filePath);
+	const BinarySplineHeader* header = file == nullptr || 
+		file->size() < sizeof(BinarySplineHeader)
+			? nullptr
+			: (const BinarySplineHeader*)file->data();
+	if (header == nullptr
+			|| std::memcmp(header->magic, SPLINE_MAGIC, 4) != 0
+			|| header->version != SPLINE_VERSION
+			|| header->count < 0
+			|| header->pointsOffset % alignof(LoopPoint) != 0
+			|| header->pointsOffset > file->size()
+			|| (file->size() - header->pointsOffset) / sizeof(LoopPoint)
+				< (size_t)header->count) {
+		printDebug("(Warning) \"" + filePath.string() + "\" is not a valid "
+			"spline file, skipping it.");
+		return nullptr;
 	}
-	return tokens;
+	if (sourceHash != nullptr && header->sourceHash != *sourceHash) {
+		printDebug("\"" + filePath.string() + "\" was made from an older "
+			"version of its ini file, reading the ini file instead.");
+		return nullptr;
+	}
+	LoopHead* spline = arena.allocate<LoopHead>();
+	spline->anonymous_0 = header->anonymous_0;
+	spline->Count = header->count;
+	spline->TotalDistance = header->totalDistance;
+	spline->Points = (LoopPoint*)(file->mutableData() + header->pointsOffset);
+	spline->Object = (ObjectFuncPtr)(uintptr_t)header->code;
+	return spline;
+}
+
+bool IniReader::writeBinarySpline(const LoopHead& spline, const std::filesystem::path& filePath, uint64_t sourceHash) {
+	BinarySplineHeader header{};
+	std::memcpy(header.magic, SPLINE_MAGIC, 4);
+	header.version = SPLINE_VERSION;
+	header.anonymous_0 = spline.anonymous_0;
+	header.count = spline.Count;
+	header.totalDistance = spline.TotalDistance;
+	header.pointsOffset = sizeof(BinarySplineHeader);
+	header.code = (uint32_t)(uintptr_t)spline.Object;
+	header.sourceHash = sourceHash;
+	std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)spline.Points, spline.Count * sizeof(LoopPoint));
+	return file.good();
 }
 
+int IniReader::convertSplines() const {
+	int convertedCount = 0;
+	for (AssetFolder folder : { AssetFolder::GdPC, AssetFolder::Paths }) {
+		for (const AssetEntry* file : assetIndex->findAll(folder, "ini")) {
+			uint64_t sourceHash;
+			if (!hashSourceFile(file->path, sourceHash)) {
+				continue;
+			}
+			const AssetEntry* binaryFile = assetIndex->find(
+				folder,
+				file->stem + "." + SPLINE_EXTENSION
+			);
+			LevelArena arena;
+			if (binaryFile != nullptr
+					&& readBinarySpline(binaryFile->path, arena, &sourceHash) != nullptr) {
+				continue;
+			}
+			// Ini files that don't parse as splines are skipped quietly, they
+			// may be other files.
+			std::string error;
+			LoopHead* spline = parseSpline(file->path.string(), arena, error);
+			std::filesystem::path binaryPath = file->path;
+			binaryPath.replace_extension(SPLINE_EXTENSION);
+			if (spline != nullptr && writeBinarySpline(*spline, binaryPath, sourceHash)) {
+				printDebug("Converted spline \"" + file->path.string() + "\" to \"" +
+					binaryPath.filename().string() + "\".");
+				convertedCount++;
+			}
+		}
+	}
+	return convertedCount;
+}
+
+
 
 
 /*************************************************************************
@@ -1,20 +1,122 @@
 #pragma once
 #include "pch.h"
+#include "AssetIndex.h"
+#include "IniDocument.h"
+#include "LevelArena.h"
+#include "SplinePool.h"
+#include "WorkerPool.h"
+#include <cstdint>
+#include <filesystem>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
+// Spline ini files are read up to point [9998].
+#define MAX_SPLINE_POINTS 9999
+// Binary spline files, see BinarySplineHeader.
+#define SPLINE_EXTENSION "sa2path"
+#define SPLINE_MAGIC "SA2P"
+#define SPLINE_VERSION 2
+// Each shared spline has an arena of its own. Point arrays bigger than this
+// get a chunk of their own, so small chunks waste little memory.
+#define SPLINE_ARENA_CHUNK_SIZE 1024
+
+/*
+  The header of a .sa2path file. It mirrors LoopHead, with the Points pointer
+  stored as a file offset and the Object pointer stored as its address. The
+  header is followed by the spline's LoopPoints, exactly as they are laid out
+  in memory, so they can be used in place. Files converted from an ini file
+  store a hash of the ini's contents, so a stale copy is never used.
+*/
+struct BinarySplineHeader {
+	char magic[4];
+	uint32_t version;
+	int16_t anonymous_0;
+	int16_t count;
+	float totalDistance;
+	uint32_t pointsOffset;
+	uint32_t code;
+	// hashContents of the source ini file, or 0 if there is none.
+	uint64_t sourceHash;
+};
+static_assert(sizeof(LoopPoint) == 20, "sa2path files store packed LoopPoints.");
 
 class IniReader {
 	public:
-		IniReader(const char* path);
+		IniReader(const char* path, const AssetIndex& assetIndex);
 		std::vector<ImportRequest> readLevelOptions();
-		LoopHead** readSplines(std::vector<std::string> splineFileNames);
-		static LoopHead* readSpline(std::string filePath);
+		static void parseLevelSection(
+			const IniSection& iniGroup,
+			const std::string& name,
+			ImportRequest& request,
+			std::vector<std::string>& warnings
+		);
+		/*
+		  Reads the given spline files, or every spline file if none are
+		  given, into a null terminated array allocated in the given arena.
+		  The array points straight at splines in the spline pool, whose
+		  references are added to sharedSplines to keep them loaded. Files
+		  are read in parallel on the worker pool. Warnings are only logged
+		  unless showWarnings is true.
+		*/
+		LoopHead** readSplines(
+			std::vector<std::string> splineFileNames,
+			bool recomputeMetrics,
+			LevelArena& arena,
+			WorkerPool& workerPool,
+			SplinePool& splinePool,
+			std::vector<std::shared_ptr<SharedSpline>>& sharedSplines,
+			bool showWarnings
+		);
+		static LoopHead* readSpline(
+			std::string filePath,
+			LevelArena& arena,
+			bool showWarnings
+		);
+		static LoopHead* readBinarySpline(
+			const std::filesystem::path& filePath,
+			LevelArena& arena,
+			const uint64_t* sourceHash = nullptr
+		);
+		/*
+		  Saves a spline as a .sa2path file, along with the hash of the ini
+		  file it was read from. Returns false on failure.
+		*/
+		static bool writeBinarySpline(
+			const LoopHead& spline,
+			const std::filesystem::path& filePath,
+			uint64_t sourceHash
+		);
+		/*
+		  Converts every ini spline in the mod folder that has no up to date
+		  .sa2path copy, and returns how many were converted. The asset
+		  index must be refreshed afterwards to see the new files.
+		*/
+		int convertSplines() const;
 
 	private:
 		const char* optionsPath;
-		const char* gdPCPath;
-		// Parses a comma seperated string for a position variable.
-		static NJS_VECTOR getPosition(std::string position);
-		// Parses a comma seperated string and returns the tokens.
-		static std::vector<std::string> getTokens(std::string value);
+		const AssetIndex* assetIndex;
+		/*
+		  Reads a spline from an ini or sa2path file, using the sa2path copy
+		  of an ini file if it was made from the ini's current contents.
+		  With recomputeMetrics, distances and rotations are then computed
+		  from the points' positions.
+		*/
+		LoopHead* loadSplineFile(
+			const AssetEntry* file,
+			bool recomputeMetrics,
+			LevelArena& arena,
+			bool showWarnings
+		) const;
+		static bool hashSourceFile(
+			const std::filesystem::path& filePath,
+			uint64_t& hash
+		);
+		static std::string normalizeSplineName(const std::string& fileName);
+		static LoopHead* parseSpline(
+			const std::string& filePath,
+			LevelArena& arena,
+			std::string& error
+		);
 };
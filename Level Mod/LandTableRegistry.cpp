@@ -0,0 +1,54 @@
+/**
+ * LandTableRegistry.cpp
+ *
+ * Description:
+ *    Resolves the data DLL's land table exports once at Init, so missing
+ *    names are reported at startup instead of crashing a level load.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "LandTableRegistry.h"
+
+LandTableRegistry::LandTableRegistry(const SymbolTable& symbolTable)
+		: symbolTable(symbolTable) {}
+
+LandTable* LandTableRegistry::resolve(const std::string& landTableName) {
+	auto it = landTables.find(landTableName);
+	if (it != landTables.end()) {
+		return it->second;
+	}
+	LandTable* landTable = (LandTable*)symbolTable.findSymbol(landTableName);
+	if (landTable == nullptr) {
+		showWarning("Warning: The land table \"" + landTableName + "\" does "
+			"not exist in the game's data DLL, levels imported over it will "
+			"be skipped. Please check the level_id and land_table_name in "
+			"your level_options.ini file.");
+	}
+	landTables.emplace(landTableName, landTable);
+	return landTable;
+}
+
+LandTable* LandTableRegistry::find(const std::string& landTableName) const {
+	auto it = landTables.find(landTableName);
+	return it == landTables.end() ? nullptr : it->second;
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,29 @@
+#pragma once
+#include "pch.h"
+#include "SymbolTable.h"
+#include <string>
+#include <unordered_map>
+
+/**
+ * The game's land tables that import requests replace, looked up once at
+ * Init instead of on every level load.
+ */
+class LandTableRegistry {
+	public:
+		LandTableRegistry(const SymbolTable& symbolTable);
+
+		/**
+		 * Looks up a land table by its export name and keeps it. Shows a
+		 * warning and returns nullptr if there is no such export. Names are
+		 * only looked up once.
+		 */
+		LandTable* resolve(const std::string& landTableName);
+
+		/* Returns a resolved land table, or nullptr if it was not found. */
+		LandTable* find(const std::string& landTableName) const;
+
+	private:
+		const SymbolTable& symbolTable;
+		// Names that were not found map to nullptr.
+		std::unordered_map<std::string, LandTable*> landTables;
+};
@@ -0,0 +1,82 @@
+/**
+ * LevelArena.cpp
+ *
+ * Description:
+ *    A bump allocator owning the memory of one level load. See LevelArena.h.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "LevelArena.h"
+#include <cstdint>
+
+LevelArena::LevelArena(size_t chunkSize) {
+	this->chunkSize = chunkSize;
+}
+
+char* LevelArena::copyString(const std::string& value) {
+	char* copy = allocate<char>(value.size() + 1);
+	std::memcpy(copy, value.c_str(), value.size());
+	return copy;
+}
+
+const MappedFile* LevelArena::mapFile(const std::filesystem::path& path) {
+	auto mappedFile = std::make_unique<MappedFile>(path, true);
+	if (!mappedFile->isOpen()) {
+		return nullptr;
+	}
+	mappedFiles.push_back(std::move(mappedFile));
+	return mappedFiles.back().get();
+}
+
+size_t LevelArena::getAllocationCount() const {
+	return allocationCount;
+}
+
+size_t LevelArena::getChunkCount() const {
+	return chunks.size();
+}
+
+size_t LevelArena::getBytesUsed() const {
+	return bytesUsed;
+}
+
+void* LevelArena::allocateBytes(size_t size, size_t alignment) {
+	size_t padding = (alignment - (uintptr_t)current % alignment) % alignment;
+	if (current == nullptr || padding + size > remaining) {
+		// Allocations bigger than a chunk get a chunk of their own.
+		size_t newChunkSize = size + alignment > chunkSize
+			? size + alignment
+			: chunkSize;
+		// Left uninitialized, allocate zeroes only the bytes it hands out.
+		chunks.push_back(std::unique_ptr<char[]>(new char[newChunkSize]));
+		current = chunks.back().get();
+		remaining = newChunkSize;
+		padding = (alignment - (uintptr_t)current % alignment) % alignment;
+	}
+	void* memory = current + padding;
+	current += padding + size;
+	remaining -= padding + size;
+	allocationCount++;
+	bytesUsed += size;
+	return memory;
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
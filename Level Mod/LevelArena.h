@@ -0,0 +1,65 @@
+#pragma once
+#include "pch.h"
+#include "MappedFile.h"
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * A bump allocator that owns every allocation made while loading a level,
+ * such as splines, along with any files mapped for it. Memory is taken from
+ * large chunks and is only given back all at once, when the arena is
+ * destroyed, so a level load makes a handful of heap calls and a level free
+ * cannot leak.
+ */
+class LevelArena {
+	public:
+		LevelArena(size_t chunkSize = 64 * 1024);
+		LevelArena(const LevelArena&) = delete;
+		LevelArena& operator=(const LevelArena&) = delete;
+
+		/**
+		 * Allocates zeroed memory for count objects of type T. The memory
+		 * lives until the arena is destroyed. Only plain structs can be
+		 * allocated, as destructors are never run.
+		 */
+		template <typename T>
+		T* allocate(size_t count = 1) {
+			static_assert(std::is_trivially_destructible<T>::value,
+				"LevelArena never runs destructors.");
+			void* memory = allocateBytes(sizeof(T) * count, alignof(T));
+			std::memset(memory, 0, sizeof(T) * count);
+			return static_cast<T*>(memory);
+		}
+
+		/** Copies a string into the arena, null terminated. */
+		char* copyString(const std::string& value);
+
+		/**
+		 * Maps a file copy on write and keeps it mapped until the arena is
+		 * destroyed. Returns nullptr if the file can't be mapped.
+		 */
+		const MappedFile* mapFile(const std::filesystem::path& path);
+
+		/** The number of allocations made by the arena. */
+		size_t getAllocationCount() const;
+
+		/** The number of heap allocations the arena currently holds. */
+		size_t getChunkCount() const;
+
+		/** The number of bytes handed out by the arena. */
+		size_t getBytesUsed() const;
+
+	private:
+		std::vector<std::unique_ptr<char[]>> chunks;
+		std::vector<std::unique_ptr<MappedFile>> mappedFiles;
+		size_t chunkSize;
+		char* current = nullptr;
+		size_t remaining = 0;
+		size_t allocationCount = 0;
+		size_t bytesUsed = 0;
+		void* allocateBytes(size_t size, size_t alignment);
+};
@@ -0,0 +1,96 @@
+/**
+ * LevelCache.cpp
+ *
+ * Description:
+ *    Keeps the resources of recently played custom levels loaded, within a
+ *    memory budget, for mods that import many levels.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "LevelCache.h"
+#include <string>
+
+LevelCache::LevelCache(size_t budget) {
+	this->budget = budget;
+}
+
+void LevelCache::setBudget(size_t budget) {
+	this->budget = budget;
+	evictToBudget();
+}
+
+void LevelCache::put(size_t requestIndex, std::unique_ptr<LevelResources> resources) {
+	if (resources == nullptr) {
+		return;
+	}
+	// A request is only cached once, replace an older copy if there is one.
+	auto existing = entriesByIndex.find(requestIndex);
+	if (existing != entriesByIndex.end()) {
+		usedMemory -= existing->second->resources->memorySize;
+		entries.erase(existing->second);
+		entriesByIndex.erase(existing);
+	}
+	usedMemory += resources->memorySize;
+	entries.push_front({ requestIndex, std::move(resources) });
+	entriesByIndex[requestIndex] = entries.begin();
+	evictToBudget();
+}
+
+std::unique_ptr<LevelResources> LevelCache::take(size_t requestIndex) {
+	auto it = entriesByIndex.find(requestIndex);
+	if (it == entriesByIndex.end()) {
+		misses++;
+		return nullptr;
+	}
+	hits++;
+	std::unique_ptr<LevelResources> resources = std::move(it->second->resources);
+	usedMemory -= resources->memorySize;
+	entries.erase(it->second);
+	entriesByIndex.erase(it);
+	return resources;
+}
+
+void LevelCache::clear() {
+	entriesByIndex.clear();
+	entries.clear();
+	usedMemory = 0;
+}
+
+void LevelCache::printStats() const {
+	printDebug("Level cache: " + std::to_string(hits) + " hit(s), " +
+		std::to_string(misses) + " miss(es), " +
+		std::to_string(entries.size()) + " level(s) using " +
+		std::to_string(usedMemory / 1024) + " of " +
+		std::to_string(budget / 1024) + " KB.");
+}
+
+void LevelCache::evictToBudget() {
+	while (usedMemory > budget && !entries.empty()) {
+		Entry& leastRecent = entries.back();
+		printDebug("Evicting level " + std::to_string(leastRecent.requestIndex) +
+			" from the level cache.");
+		usedMemory -= leastRecent.resources->memorySize;
+		entriesByIndex.erase(leastRecent.requestIndex);
+		entries.pop_back();
+	}
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
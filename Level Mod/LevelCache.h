@@ -0,0 +1,53 @@
+#pragma once
+#include "pch.h"
+#include "LevelResources.h"
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+/**
+ * A least recently used cache of the resources of levels that are no longer
+ * active, so entering a level again does not read it from disk. Levels are
+ * evicted once the cache holds more than its memory budget, which is kept
+ * small as the game is a 32-bit process.
+ */
+class LevelCache {
+	public:
+		LevelCache(size_t budget);
+
+		/** Changes the memory budget, evicting levels if needed. */
+		void setBudget(size_t budget);
+
+		/**
+		 * Adds a level's resources to the cache as the most recently used
+		 * level. Evicts the least recently used levels until the cache fits
+		 * its budget, which may be the level that was just added.
+		 */
+		void put(size_t requestIndex, std::unique_ptr<LevelResources> resources);
+
+		/**
+		 * Removes and returns a level's resources, or nullptr if the level is
+		 * not cached. Counts as a hit or a miss.
+		 */
+		std::unique_ptr<LevelResources> take(size_t requestIndex);
+
+		/** Frees every cached level. */
+		void clear();
+
+		/** Logs the hit and miss counters and memory use. */
+		void printStats() const;
+
+	private:
+		struct Entry {
+			size_t requestIndex;
+			std::unique_ptr<LevelResources> resources;
+		};
+		// Most recently used first.
+		std::list<Entry> entries;
+		std::unordered_map<size_t, std::list<Entry>::iterator> entriesByIndex;
+		size_t budget;
+		size_t usedMemory = 0;
+		unsigned int hits = 0;
+		unsigned int misses = 0;
+		void evictToBudget();
+};
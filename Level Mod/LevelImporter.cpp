@@ -21,114 +21,183 @@
 #include "LevelImporter.h"
 #include "SetupHelpers.h"
 #include "IniReader.h"
+#include "LevelOptionsIndex.h"
+#include "LevelTable.h"
+#include "MappedFile.h"
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <chrono>
 #include <cstdio>
 #include <filesystem>
+#include <memory>
+#include <thread>
 #include <vector>
-// By default, LevelImporter supports up to 256 custom textures.
-// Change the number in here if you need more, the game has a max of 500.
-#define NUMBER_OF_TEXTURES 256
+// How much memory levels that are no longer active may keep using, so they
+// load instantly when played again. Use setLevelCacheBudget to change it.
+#define LEVEL_CACHE_BUDGET (64 * 1024 * 1024)
+// How many imported levels are read ahead at Init. Every other level is read
+// when it is first played, so Init memory doesn't grow with the mod.
+#define PRELOAD_LEVEL_COUNT 3
+// The most threads reading spline files at once, besides the threads asking
+// for them.
+#define MAX_SPLINE_THREADS 4
+
+/*
+  Spline reads are short and mostly wait on the disk, so a few threads are
+  enough, and the game keeps at least one core to itself.
+*/
+static size_t getSplineThreadCount() {
+	size_t coreCount = std::thread::hardware_concurrency();
+	return coreCount > 2 ? std::min<size_t>(coreCount - 2, MAX_SPLINE_THREADS) : 0;
+}
 
 LevelImporter::LevelImporter(
 		const char* modFolderPath,
 		const HelperFunctions& helperFunctions)
-			: helperFunctions(helperFunctions) {
-	this->iniReader = new IniReader(modFolderPath);
+			: workerPool(getSplineThreadCount()),
+			levelCache(LEVEL_CACHE_BUDGET),
+			landTableRegistry(dataDllSymbols),
+			helperFunctions(helperFunctions) {
+	this->assetIndex = new AssetIndex(modFolderPath);
+	this->iniReader = new IniReader(modFolderPath, *assetIndex);
 	this->modFolderPath = std::string(modFolderPath);
-	this->gdPCPath = std::string(modFolderPath).append("\\gd_PC\\");
-	this->PRSPath = std::string(gdPCPath).append("PRS\\");
 }
 
-void LevelImporter::importLevel(std::string landTableName) {
-	importLevel(landTableName, {});
+void LevelImporter::importLevel(const std::string& landTableName) {
+	importLevel(landTableName, LevelOptions());
+}
+
+void LevelImporter::importLevel(const std::string& landTableName, const LevelOptions& levelOptions) {
+	ImportRequest request;
+	request.landTableName = landTableName;
+	request.levelOptions = levelOptions;
+	detectLevelFiles(request);
+	addImportRequest(std::move(request));
 }
 
-void LevelImporter::importLevel(std::string landTableName, LevelOptions levelOptions) {
+void LevelImporter::detectLevelFiles(ImportRequest& request) {
 	// Attempt to find chunk formatted file first, if not fallback on sa2blvl.
-	std::string levelFile = detectFile(gdPCPath, "sa2lvl");
+	std::string levelFile = detectFile(AssetFolder::GdPC, "sa2lvl");
 	if (levelFile.empty()) {
-		levelFile = detectFile(gdPCPath, "sa2blvl");
+		levelFile = detectFile(AssetFolder::GdPC, "sa2blvl");
 	}
-	importLevel(
-		landTableName,
-		removeFileExtension(levelFile),
-		detectFile(PRSPath, "pak"),
-		levelOptions
-	);
+	request.levelFileName = removeFileExtension(levelFile);
+	request.pakFileName = detectFile(AssetFolder::PRS, "pak");
 }
 
-void LevelImporter::importLevel(std::string landTableName, std::string levelFileName, std::string pakFileName) {
-	return importLevel(landTableName, levelFileName, pakFileName, {});
+void LevelImporter::importLevel(const std::string& landTableName, const std::string& levelFileName, const std::string& pakFileName) {
+	importLevel(landTableName, levelFileName, pakFileName, LevelOptions());
 }
 
-void LevelImporter::importLevel(std::string landTableName, std::string levelFileName, std::string pakFileName, LevelOptions levelOptions) {
-	if (landTableName.empty()) {
-		printDebug("Invalid land table name or level ID. Skipping import");
-		return;
-	}
-	if (levelFileName.empty() || pakFileName.empty()) {
-		printDebug("Invalid level or pak file name. Skipping import.");
-		return;
-	}
+void LevelImporter::importLevel(const std::string& landTableName, const std::string& levelFileName, const std::string& pakFileName, const LevelOptions& levelOptions) {
 	ImportRequest request;
-	request.levelID = getLevelID(landTableName);
 	request.landTableName = landTableName;
 	request.levelFileName = levelFileName;
-	request.pakFileName = pakFileName,
+	request.pakFileName = pakFileName;
 	request.levelOptions = levelOptions;
-	importRequests.push_back(request);
-	// Positions must be registered before the level is loaded.
-	registerPosition(levelOptions.startPosition, request.levelID, true);
-	registerPosition(levelOptions.endPosition, request.levelID, false);
+	addImportRequest(std::move(request));
 }
 
 void LevelImporter::importLevel(LevelIDs levelID) {
-	importLevel(levelID, {});
+	importLevel(levelID, LevelOptions());
 }
 
-void LevelImporter::importLevel(LevelIDs levelID, LevelOptions levelOptions) {
+void LevelImporter::importLevel(LevelIDs levelID, const LevelOptions& levelOptions) {
 	importLevel(getLandTableName(levelID), levelOptions);
 }
 
-void LevelImporter::importLevel(LevelIDs levelID, std::string levelFileName, std::string pakFileName) {
-	importLevel(levelID, levelFileName, pakFileName, {});
+void LevelImporter::importLevel(LevelIDs levelID, const std::string& levelFileName, const std::string& pakFileName) {
+	importLevel(levelID, levelFileName, pakFileName, LevelOptions());
 }
 
-void LevelImporter::importLevel(LevelIDs levelID, std::string levelFileName, std::string pakFileName, LevelOptions levelOptions) {
+void LevelImporter::importLevel(LevelIDs levelID, const std::string& levelFileName, const std::string& pakFileName, const LevelOptions& levelOptions) {
 	importLevel(getLandTableName(levelID), levelFileName, pakFileName, levelOptions);
 }
 
-void LevelImporter::importLevels(std::vector<ImportRequest> requests) {
-	for (ImportRequest request : requests) {
+void LevelImporter::importLevels(std::vector<ImportRequest>&& requests) {
+	for (ImportRequest& request : requests) {
+		const LevelEntry* level = findLevel(request.levelID);
+		if (level != nullptr) {
+			request.landTableName = level->getLandTableName();
+		}
+		// Requests that are only indexed are completed by resolveRequest,
+		// when their options are parsed.
+		if (request.optionsIndex == nullptr
+				&& (request.levelFileName.empty() || request.pakFileName.empty())) {
+			detectLevelFiles(request);
+		}
+		addImportRequest(std::move(request));
+	}
+	// Every level is known at this point, so the first few can be read ahead
+	// of the level load hook. importLevel may still add requests while the
+	// workers run, so they get their own list of the requests, which never
+	// move once added. Job i loads request i.
+	auto preloadRequests = std::make_shared<std::vector<const ImportRequest*>>();
+	for (const ImportRequest& request : importRegistry.getRequests()) {
+		if (preloadRequests->size() == PRELOAD_LEVEL_COUNT) {
+			break;
+		}
+		preloadRequests->push_back(&request);
+	}
+	// Splines are read automatically only when the mod imports one level.
+	bool readAllSplines = importRegistry.size() == 1;
+	levelPreloader.start(preloadRequests->size(), [this, preloadRequests, readAllSplines](size_t index) {
+		const ImportRequest& request = resolveRequest(*(*preloadRequests)[index], false);
+		return loadLevelResources(request, readAllSplines, false);
+	});
+}
+
+void LevelImporter::addImportRequest(ImportRequest&& request) {
+	if (request.landTableName.empty()) {
+		printDebug("Invalid land table name or level ID. Skipping import");
+		return;
+	}
+	request.levelID = getLevelID(request.landTableName);
+	if (request.optionsIndex == nullptr) {
 		if (request.levelFileName.empty() || request.pakFileName.empty()) {
-			if (request.levelID != LevelIDs_Invalid) {
-				importLevel(request.levelID, request.levelOptions);
-			} else {
-				importLevel(request.landTableName, request.levelOptions);
+			printDebug("Invalid level or pak file name. Skipping import.");
+			return;
+		}
+	}
+	// Positions must be registered before the level is loaded. Indexed
+	// requests have theirs read while indexing.
+	registerPosition(request.levelOptions.startPosition, request.levelID, true);
+	registerPosition(request.levelOptions.endPosition, request.levelID, false);
+	// Missing land tables are reported here, at Init, and their requests
+	// are skipped when their level loads.
+	landTableRegistry.resolve(request.landTableName);
+	importRegistry.add(std::move(request));
+}
+
+const ImportRequest& LevelImporter::resolveRequest(const ImportRequest& request, bool showWarnings) {
+	if (request.optionsIndex == nullptr) {
+		return request;
+	}
+	const ImportRequest& resolvedRequest = request.optionsIndex->resolve(
+		request,
+		[this](ImportRequest& parsedRequest) {
+			if (parsedRequest.levelFileName.empty() || parsedRequest.pakFileName.empty()) {
+				detectLevelFiles(parsedRequest);
 			}
-			continue;
 		}
-		importLevel(
-			request.landTableName,
-			request.levelFileName,
-			request.pakFileName,
-			request.levelOptions
-		);
+	);
+	if (showWarnings) {
+		for (const std::string& warning : request.optionsIndex->takeWarnings(request.optionsSection)) {
+			showWarning("Warning: " + warning);
+		}
 	}
+	return resolvedRequest;
 }
 
 std::string LevelImporter::getLandTableName(LevelIDs levelID) {
-	return "objLandTable00" + std::to_string(levelID);
+	const LevelEntry* level = findLevel(levelID);
+	return level == nullptr ? std::string() : std::string(level->getLandTableName());
 }
 
-LevelIDs LevelImporter::getLevelID(std::string landTableName) {
-	size_t lastDot = landTableName.find_last_of("00");
-	if (lastDot != std::string::npos) {
-		return (LevelIDs)std::stoi(landTableName.substr(lastDot));
-	}
-	return  LevelIDs_Invalid;
+LevelIDs LevelImporter::getLevelID(const std::string& landTableName) {
+	const LevelEntry* level = findLevel(landTableName);
+	return level == nullptr ? LevelIDs_Invalid : level->levelID;
 }
 
 void LevelImporter::onFrame() {
@@ -147,79 +216,202 @@ void LevelImporter::onFrame() {
 }
 
 void LevelImporter::onLevelLoad() {
-	freeLevelResources();
+	auto loadStart = std::chrono::steady_clock::now();
+	auto printLoadTime = [&loadStart](std::string message) {
+		auto loadTime = std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - loadStart);
+		printDebug(message + " Level load hook took " +
+			std::to_string(loadTime.count()) + " ms.");
+	};
+	// Restarts and retries load the same level again, which can reuse what is
+	// already loaded instead of reading it from disk.
+	if (!activeLevels.empty() && CurrentLevel == activeLevelID) {
+		resetActiveLevels();
+		printLoadTime("Custom level reset.");
+		return;
+	}
+	cacheActiveLevels();
 	bool levelWasImported = false;
-	for (ImportRequest request : importRequests) {
-		bool isCurrentLevel = request.levelID == CurrentLevel;
-		bool isChaoGarden = CurrentLevel == LevelIDs_ChaoWorld;
-		bool isChaoGardenRequest = 
-			request.levelID == LevelIDs_Invalid && !request.landTableName.empty();
-		bool shouldImportLevel = isCurrentLevel || (isChaoGarden && isChaoGardenRequest);
-		if (shouldImportLevel) {
-			LandTable* newLandTable = generateLandTable(
-				request.levelFileName,
-				request.pakFileName,
-				request.landTableName
-			);
-			if (newLandTable != nullptr) {
-				replaceLandTable(newLandTable, request.landTableName);
-				setLevelOptions(request.levelOptions);
-				levelWasImported = true;
-			}
+	for (size_t index : importRegistry.findLevelRequests((LevelIDs)CurrentLevel)) {
+		levelWasImported |= loadImportRequest(index);
+	}
+	// Chao garden requests replace a land table by name, and are all loaded
+	// with the chao world.
+	if (CurrentLevel == LevelIDs_ChaoWorld) {
+		for (size_t index : importRegistry.getChaoGardenRequests()) {
+			levelWasImported |= loadImportRequest(index);
 		}
 	}
+	cachePreloadedLevels();
 	if (levelWasImported) {
-		printDebug("Level import was successful.");
+		activeLevelID = (LevelIDs)CurrentLevel;
+		levelCache.printStats();
+		printLoadTime("Level import was successful.");
 	}
 }
 
-LandTable* LevelImporter::generateLandTable(std::string levelFileName, std::string pakFileName, std::string landTableName) {
+bool LevelImporter::loadImportRequest(size_t index) {
 	printDebug("Custom level load detected.");
+	const ImportRequest& importRequest = importRegistry.get(index);
+	LandTable* landTable = landTableRegistry.find(importRequest.landTableName);
+	if (landTable == nullptr) {
+		printDebug("Land table \"" + importRequest.landTableName +
+			"\" not found, skipping import.");
+		return false;
+	}
+	const ImportRequest& request = resolveRequest(importRequest, true);
+	// Use a cached or preloaded level if there is one, otherwise read it now.
+	std::unique_ptr<LevelResources> resources = levelCache.take(index);
+	if (resources == nullptr) {
+		resources = levelPreloader.take(index);
+	}
+	if (resources == nullptr) {
+		resources = loadLevelResources(request, importRegistry.size() == 1, true);
+	}
+	if (resources == nullptr) {
+		return false;
+	}
+	resources->requestIndex = index;
+	*landTable = *resources->landTable;
+	setLevelOptions(request.levelOptions, *resources);
+	activeLandTables.push_back(resources->landTableInfo.get());
+	for (const SplineSampler& splineSampler : resources->splineSamplers) {
+		activeSplineSamplers.push_back(&splineSampler);
+	}
+	activeLevels.push_back(std::move(resources));
+	return true;
+}
+
+void LevelImporter::resetActiveLevels() {
+	for (const std::unique_ptr<LevelResources>& resources : activeLevels) {
+		const ImportRequest& request = importRegistry.get(resources->requestIndex);
+		*landTableRegistry.find(request.landTableName) = *resources->landTable;
+		if (resources->splines != nullptr) {
+			LoadStagePaths(resources->splines);
+		}
+	}
+}
 
+std::string LevelImporter::findLevelFile(const ImportRequest& request, bool showWarnings) {
 	// Check and install the correct level format.
-	std::string levelFilePath;
-	std::string chunkFilePath = gdPCPath + removeFileExtension(levelFileName) + ".sa2lvl";
-	if (std::filesystem::exists(chunkFilePath)) {
+	std::string levelStem = removeFileExtension(request.levelFileName);
+	const AssetEntry* chunkFile =
+		assetIndex->find(AssetFolder::GdPC, levelStem + ".sa2lvl");
+	if (chunkFile != nullptr) {
 		if (helperFunctions.Mods->find("sa2-render-fix") == helperFunctions.Mods->end()) {
-			showWarning("Warning: Render Fix version 1.5 or newer is required to use sa2lvl files.");
-			return nullptr;
+			showWarning("Warning: Render Fix version 1.5 or newer is required to "
+				"use sa2lvl files.", showWarnings);
+			return std::string();
 		}
-		levelFilePath = chunkFilePath;
+		return chunkFile->path.string();
 	}
-	else {
-		levelFilePath = gdPCPath + removeFileExtension(levelFileName).append(".sa2blvl");
-		if (!std::filesystem::exists(levelFilePath)) {
-			showWarning("Error: " + levelFilePath + " not found! Sa2lvl was also checked for and "
-				"could not be found.");
-			return nullptr;
-		}
+	const AssetEntry* basicFile =
+		assetIndex->find(AssetFolder::GdPC, levelStem + ".sa2blvl");
+	if (basicFile == nullptr) {
+		std::string levelFilePath = (assetIndex->getFolderPath(AssetFolder::GdPC) /
+			(levelStem + ".sa2blvl")).string();
+		showWarning("Error: " + levelFilePath + " not found! Sa2lvl was also "
+			"checked for and could not be found.", showWarnings);
+		return std::string();
+	}
+	return basicFile->path.string();
+}
+
+std::unique_ptr<LevelResources> LevelImporter::loadLevelResources(const ImportRequest& request, bool readAllSplines, bool showWarnings) {
+	std::string levelFilePath = findLevelFile(request, showWarnings);
+	if (levelFilePath.empty()) {
+		return nullptr;
 	}
 	printDebug("Attempting to import \"" + levelFilePath + " with "
-		"texture pack \"" + pakFileName + ".pak\" over land table \"" +
-		landTableName + ".\"");
-	LandTableInfo* landTableInfo = new LandTableInfo(levelFilePath);
-	activeLandTables.push_back(landTableInfo);
-	LandTable* newLandTable = landTableInfo->getlandtable();
+		"texture pack \"" + request.pakFileName + ".pak\" over land table \"" +
+		request.landTableName + ".\"");
+	auto resources = std::make_unique<LevelResources>();
+	resources->landTableInfo = loadLandTableInfo(levelFilePath);
+	LandTable* newLandTable = resources->landTableInfo->getlandtable();
 	if (newLandTable == nullptr) {
-		showWarning("Error: Failed to generate land table from \"" + levelFilePath + "\". Skipping import.");
+		showWarning("Error: Failed to generate land table from \"" +
+			levelFilePath + "\". Skipping import.", showWarnings);
 		return nullptr;
 	}
-	NJS_TEXNAME* customTextureNames = new NJS_TEXNAME[NUMBER_OF_TEXTURES]{};
-	NJS_TEXLIST* texList = new NJS_TEXLIST{ customTextureNames, NUMBER_OF_TEXTURES };
-	newLandTable->TextureList = texList;
-	newLandTable->TextureName = _strdup(removeFileExtension(pakFileName).c_str());
-	return newLandTable;
+	// The texlist is sized to the texture pack, up to the game's max of 500.
+	resources->texList = texListCache.get(*assetIndex, request.pakFileName, showWarnings);
+	newLandTable->TextureList = &resources->texList->texList;
+	newLandTable->TextureName = resources->texList->textureName.c_str();
+	resources->landTable = newLandTable;
+	LevelArena& arena = resources->arena;
+
+	const LevelOptions& options = request.levelOptions;
+	if (!options.splineFileNames.empty()) {
+		printDebug("Spline files detected.");
+		resources->splines = iniReader->readSplines(
+			options.splineFileNames,
+			options.recomputeSplineMetrics,
+			arena,
+			workerPool,
+			splinePool,
+			resources->sharedSplines,
+			showWarnings
+		);
+	}
+	else if (readAllSplines) {
+		printDebug("Attempting to look for splines.");
+		resources->splines = iniReader->readSplines(
+			options.splineFileNames,
+			options.recomputeSplineMetrics,
+			arena,
+			workerPool,
+			splinePool,
+			resources->sharedSplines,
+			showWarnings
+		);
+	}
+	for (LoopHead** spline = resources->splines;
+			spline != nullptr && *spline != nullptr; spline++) {
+		resources->splineSamplers.emplace_back(**spline);
+	}
+	printDebug("Level memory: " + std::to_string(arena.getAllocationCount()) +
+		" allocation(s), " + std::to_string(arena.getBytesUsed()) + " bytes in " +
+		std::to_string(arena.getChunkCount()) + " heap block(s).");
+
+	// Estimate the memory used, for the level cache's budget.
+	std::error_code error;
+	uintmax_t levelFileSize = std::filesystem::file_size(levelFilePath, error);
+	resources->memorySize = error ? 0 : (size_t)levelFileSize;
+	resources->memorySize += arena.getBytesUsed() +
+		resources->texList->texList.nbTexture * sizeof(NJS_TEXNAME);
+	for (LoopHead** spline = resources->splines;
+			spline != nullptr && *spline != nullptr; spline++) {
+		// Pooled splines are counted in full, even when shared. Each point
+		// also has a distance and a tree entry in its sampler.
+		resources->memorySize += sizeof(LoopHead) + sizeof(SplineSampler) +
+			(*spline)->Count * (sizeof(LoopPoint) + sizeof(float) + sizeof(uint32_t));
+	}
+	return resources;
+}
+
+std::unique_ptr<LandTableInfo> LevelImporter::loadLandTableInfo(const std::string& levelFilePath) {
+	// LandTableInfo reads from the mapped file directly, instead of through
+	// ifstream's buffer.
+	MappedFile levelFile(levelFilePath);
+	if (levelFile.isOpen()) {
+		MemoryStreamBuffer buffer(levelFile.data(), levelFile.size());
+		std::istream stream(&buffer);
+		return std::make_unique<LandTableInfo>(stream);
+	}
+	printDebug("(Warning) Could not memory map \"" + levelFilePath +
+		"\", reading it normally.");
+	return std::make_unique<LandTableInfo>(levelFilePath);
 }
 
-void LevelImporter::setLevelOptions(LevelOptions options) {
+void LevelImporter::setLevelOptions(const LevelOptions& options, const LevelResources& resources) {
 	auto positionToString = [](NJS_VECTOR v) {
 		return
 			std::to_string(v.x) + ", " +
 			std::to_string(v.y) + ", " +
 			std::to_string(v.z) + ".";
 	};
-	// No registerStartPosition calls here, as positions should be
-	// pre-registered in the importLevel function.
+	// No registerPosition calls here, as positions are registered in
+	// addImportRequest, before any level loads.
 	printDebug("Setting spawn position to: " +
 		positionToString(options.startPosition));
 	printDebug("Setting victory position to: " +
@@ -229,42 +421,28 @@ void LevelImporter::setLevelOptions(LevelOptions options) {
 		printDebug("Setting simple death plane to: " +
 			std::to_string(options.simpleDeathPlane));
 	}
-	if (!options.splineFileNames.empty()) {
-		printDebug("Spline files detected.");
-		LoopHead** spline = iniReader->readSplines(options.splineFileNames);
-		if (spline != nullptr) {
-			LoadStagePaths(spline);
-			activeSplines.push_back(spline);
-		}
-	}
-	else if (importRequests.size() == 1) {
-		printDebug("Attempting to look for splines.");
-		LoopHead** spline = iniReader->readSplines(options.splineFileNames);
-		if (spline != nullptr) {
-			LoadStagePaths(spline);
-			activeSplines.push_back(spline);
-		}
+	if (resources.splines != nullptr) {
+		LoadStagePaths(resources.splines);
 	}
 	activeOptions = options;
 }
 
-void LevelImporter::replaceLandTable(LandTable* newLandTable, std::string landTableName) {
-	LandTable* oldLandTable = (LandTable*)GetProcAddress(
-		**datadllhandle,
-		landTableName.c_str()
-	);
-	*oldLandTable = *newLandTable;
+std::string LevelImporter::detectFile(AssetFolder folder, std::string fileExtension) {
+	const AssetEntry* file = assetIndex->findFirst(folder, fileExtension);
+	if (file == nullptr) {
+		return std::string();
+	}
+	std::string fileName = file->path.filename().string();
+	printDebug("Detected level file, using \"" + fileName + "\" for import.");
+	return fileName;
 }
 
-std::string LevelImporter::detectFile(std::string path, std::string fileExtension) {
-	for (const auto& file : std::filesystem::directory_iterator(path)) {
-		const auto fileName = file.path().filename();
-		if (fileName.extension().string() == "." + fileExtension) {
-			printDebug("Detected level file, using \"" + fileName.string() + "\" for import.");
-			return fileName.string(); 
-		}
-	}
-	return std::string();
+const std::deque<ImportRequest>& LevelImporter::getImportRequests() const {
+	return importRegistry.getRequests();
+}
+
+AssetIndex& LevelImporter::getAssetIndex() {
+	return *assetIndex;
 }
 
 void LevelImporter::registerPosition(
@@ -288,27 +466,46 @@ void LevelImporter::registerPosition(
 	}
 }
 
-void LevelImporter::freeLevelResources() {
-	for (LoopHead** spline : activeSplines) {
-		if (spline != nullptr) {
-			delete[] spline;
-		}
+void LevelImporter::cacheActiveLevels() {
+	for (std::unique_ptr<LevelResources>& resources : activeLevels) {
+		size_t requestIndex = resources->requestIndex;
+		levelCache.put(requestIndex, std::move(resources));
 	}
-	activeSplines.clear();
-	for (LandTableInfo* landTableInfo : activeLandTables) {
-		if (landTableInfo != nullptr) {
-			delete landTableInfo;
+	freeLevelResources();
+}
+
+void LevelImporter::cachePreloadedLevels() {
+	for (size_t index = 0; index < levelPreloader.getJobCount(); index++) {
+		std::unique_ptr<LevelResources> resources = levelPreloader.takeFinished(index);
+		if (resources != nullptr) {
+			resources->requestIndex = index;
+			levelCache.put(index, std::move(resources));
 		}
 	}
+}
+
+void LevelImporter::setLevelCacheBudget(size_t budget) {
+	levelCache.setBudget(budget);
+}
+
+void LevelImporter::freeLevelResources() {
 	activeLandTables.clear();
+	activeSplineSamplers.clear();
+	activeLevels.clear();
+	activeLevelID = LevelIDs_Invalid;
 	activeOptions = {};
 }
 
 void LevelImporter::free() {
+	levelPreloader.stop();
 	freeLevelResources();
+	levelCache.clear();
 	if (iniReader != nullptr) {
 		delete iniReader;
 	}
+	if (assetIndex != nullptr) {
+		delete assetIndex;
+	}
 }
 
 
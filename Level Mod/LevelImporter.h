@@ -1,6 +1,17 @@
 #pragma once
 #include "pch.h"
+#include "AssetIndex.h"
+#include "DataDllSymbolTable.h"
+#include "ImportRegistry.h"
 #include "IniReader.h"
+#include "LandTableRegistry.h"
+#include "LevelCache.h"
+#include "LevelPreloader.h"
+#include "LevelResources.h"
+#include "SplinePool.h"
+#include "WorkerPool.h"
+#include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 #include <curl/curl.h>
@@ -17,7 +28,7 @@ class LevelImporter {
 		 * 
 		 * @param [landTableName] - The name of the land table to replace.
 		 */
-		void importLevel(std::string landTableName);
+		void importLevel(const std::string& landTableName);
 
 		/**
 		 * Imports a custom level over an existing level. Automatically detects
@@ -28,8 +39,8 @@ class LevelImporter {
 		 * @param [levelOptions] - The features enabled for this level.
 		 */
 		void importLevel(
-			std::string landTableName,
-			LevelOptions levelOptions
+			const std::string& landTableName,
+			const LevelOptions& levelOptions
 		);
 
 		/**
@@ -40,9 +51,9 @@ class LevelImporter {
 		 * @param [pakFileName] - The name of the pak file to use.
 		 */
 		void importLevel(
-			std::string landTableName,
-			std::string levelFileName,
-			std::string pakFileName
+			const std::string& landTableName,
+			const std::string& levelFileName,
+			const std::string& pakFileName
 		);
 
 		/**
@@ -54,10 +65,10 @@ class LevelImporter {
 		 * @param [levelOptions] - The features enabled for this level.
 		 */
 		void importLevel(
-			std::string landTableName,
-			std::string levelFileName,
-			std::string pakFileName,
-			LevelOptions levelOptions
+			const std::string& landTableName,
+			const std::string& levelFileName,
+			const std::string& pakFileName,
+			const LevelOptions& levelOptions
 		);
 
 		/**
@@ -79,7 +90,7 @@ class LevelImporter {
 		 */
 		void importLevel(
 			LevelIDs levelID,
-			LevelOptions levelOptions
+			const LevelOptions& levelOptions
 		);
 
 		/**
@@ -91,8 +102,8 @@ class LevelImporter {
 		 */
 		void importLevel(
 			LevelIDs levelID,
-			std::string levelFileName,
-			std::string pakFileName
+			const std::string& levelFileName,
+			const std::string& pakFileName
 		);
 
 		/**
@@ -104,23 +115,26 @@ class LevelImporter {
 		 */
 		void importLevel(
 			LevelIDs levelID,
-			std::string levelFileName,
-			std::string pakFileName,
-			LevelOptions levelOptions
+			const std::string& levelFileName,
+			const std::string& pakFileName,
+			const LevelOptions& levelOptions
 		);
 
 		/**
 		 * Imports multiple custom levels into the game. Convenience method for
-		 * My Level Mod, which knows all level imports at startup.
+		 * My Level Mod, which knows all level imports at startup. The first
+		 * few imported levels are loaded on background threads, ahead of the
+		 * game asking for them.
 		 */
-		void importLevels(std::vector<ImportRequest> requests);
+		void importLevels(std::vector<ImportRequest>&& requests);
 
 		/* Runs on every frame, used to enable My Level Mod features. */
 		void onFrame();
 
 		/*
 		  Loads a custom level and its resources if the game attempts to load a
-		  level designated for replacement.
+		  level designated for replacement. If the level is already loaded,
+		  such as on a restart, its resources are reused.
 		*/
 		void onLevelLoad();
 
@@ -133,38 +147,140 @@ class LevelImporter {
 		/* Frees the memory allocated by LevelImporter. */
 		void free();
 
+		/**
+		 * Sets how much memory, in bytes, levels that are no longer active may
+		 * keep using so they load faster when played again. Set to 0 to free
+		 * levels as soon as they are left.
+		 */
+		void setLevelCacheBudget(size_t budget);
+
 		/*
 		  A list of pointers to the currently loaded custom land tables. 
 		  Typically containing one element, the only scenario this list has
 		  multiple elements is if multiple chao gardens are being replaced.
+		  The land tables are owned by LevelImporter, do not delete them.
 		*/
 		std::vector<LandTableInfo*> activeLandTables;
 
-		std::vector<ImportRequest> importRequests;
-		LevelIDs getLevelID(std::string landTableName);
+		/*
+		  Samplers for the splines of the currently loaded custom levels, for
+		  custom code that needs to find its way along a rail, e.g.
+		  findNearestPoint(MainCharObj1[0]->Position). Owned by LevelImporter,
+		  and only valid until the level is left.
+		*/
+		std::vector<const SplineSampler*> activeSplineSamplers;
+
+		/*
+		  Every imported level, in the order they were imported. Requests
+		  never move once added.
+		*/
+		const std::deque<ImportRequest>& getImportRequests() const;
+		/* Returns the level ID of a stage's land table, or LevelIDs_Invalid. */
+		LevelIDs getLevelID(const std::string& landTableName);
+		/* Returns a stage's land table name, or an empty string. */
 		std::string getLandTableName(LevelIDs levelID);
 
+		/* The index of the mod folder's files, built once at Init. */
+		AssetIndex& getAssetIndex();
+
     // TODO: Implement replaceLevelInit as an alternative import method.
 	private:
 		std::string modFolderPath;
-		std::string gdPCPath;
-		std::string PRSPath;
+		AssetIndex* assetIndex;
+		ImportRegistry importRegistry;
 		IniReader* iniReader;
-		std::vector<LoopHead**> activeSplines;
+		// Owns the resources of the currently loaded custom levels.
+		std::vector<std::unique_ptr<LevelResources>> activeLevels;
+		// The level the active resources were loaded for.
+		LevelIDs activeLevelID = LevelIDs_Invalid;
+		// Declared before the preloader, whose threads use them.
+		TexListCache texListCache;
+		// Reads a level's spline files in parallel, for the preloader and the
+		// level load hook alike.
+		WorkerPool workerPool;
+		// Splines shared by every level using the same spline file.
+		SplinePool splinePool;
+		LevelPreloader levelPreloader;
+		LevelCache levelCache;
+		DataDllSymbolTable dataDllSymbols;
+		// The land tables replaced by imported levels, looked up once at
+		// Init.
+		LandTableRegistry landTableRegistry;
 		LevelOptions activeOptions;
 		const HelperFunctions& helperFunctions;
-		LandTable* generateLandTable(std::string levelFileName,
-			std::string pakFileName,
-			std::string landTableName
+		/*
+		  Adds a request to the registry, completing its level ID. Requests
+		  without a land table, or without level files once parsed, are
+		  skipped.
+		*/
+		void addImportRequest(ImportRequest&& request);
+		/*
+		  Loads the request at the given index over the current level, by
+		  replacing an existing level's land table. Returns false if its
+		  level could not be loaded. Warning: This keeps the LevelHeader.Init
+		  method in-tact, causing original level assets to load. This may
+		  cause missing texture crashes depending on your level.
+		*/
+		bool loadImportRequest(size_t index);
+		/*
+		  Returns a request with its options parsed. Requests read from
+		  level_options.ini are only indexed at Init, so the first call for
+		  one parses its section and detects its files. Thread safe, warnings
+		  are only shown if showWarnings is true.
+		*/
+		const ImportRequest& resolveRequest(
+			const ImportRequest& request,
+			bool showWarnings
 		);
-		void setLevelOptions(LevelOptions options);
+		/* Fills in the first level and pak files found in the mod folder. */
+		void detectLevelFiles(ImportRequest& request);
+		/*
+		  Returns the path of the sa2lvl or sa2blvl file to use for a request,
+		  or an empty string if there is no usable level file.
+		*/
+		std::string findLevelFile(
+			const ImportRequest& request,
+			bool showWarnings
+		);
+		/*
+		  Reads a request's level file and splines from disk. Safe to call
+		  from a background thread. Every spline file is read for requests
+		  without spline file names if readAllSplines is true, which must be
+		  worked out on the main thread. Returns nullptr if the level can't
+		  be loaded, warnings are only logged unless showWarnings is true.
+		*/
+		std::unique_ptr<LevelResources> loadLevelResources(
+			const ImportRequest& request,
+			bool readAllSplines,
+			bool showWarnings
+		);
+		/*
+		  Reads a sa2lvl or sa2blvl file through a memory map, falling back on
+		  a normal file read if the file can't be mapped.
+		*/
+		static std::unique_ptr<LandTableInfo> loadLandTableInfo(
+			const std::string& levelFilePath
+		);
+		void setLevelOptions(
+			const LevelOptions& options,
+			const LevelResources& resources
+		);
+		/*
+		  Puts the active land tables and splines back in place without
+		  reading anything from disk. Used when the same level loads again.
+		*/
+		void resetActiveLevels();
+		/*
+		  Moves the active levels into the level cache, so they can be reused
+		  if the player returns to them.
+		*/
+		void cacheActiveLevels();
 		/*
-		  Imports a level into Sonic Adventure 2 by replacing an existing
-		  level's land table. Warning: This method keeps the LevelHeader.Init
-		  method in-tact, causing original level assets to load. This may cause
-		  missing texture crashes depending on your level.
+		  Moves the preloaded levels that weren't played into the level
+		  cache, so they count against its budget instead of staying loaded
+		  until exit. Levels still being preloaded are moved by a later call.
 		*/
-		void replaceLandTable(LandTable* landTableInfo, std::string landTableName);
+		void cachePreloadedLevels();
 		void registerPosition(NJS_VECTOR position, LevelIDs levelID, bool isStart);
-		static std::string detectFile(std::string path, std::string fileExtension);
+		std::string detectFile(AssetFolder folder, std::string fileExtension);
 };
@@ -0,0 +1,104 @@
+/**
+ * LevelOptionsIndex.cpp
+ *
+ * Description:
+ *    Defers completing level_options.ini sections until their level is
+ *    needed, so Init only pays for indexing the file and, when the options
+ *    cache is out of date, parsing it once to rebuild the cache.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "LevelOptionsIndex.h"
+#include "IniDocument.h"
+#include "IniReader.h"
+
+LevelOptionsIndex::LevelOptionsIndex(std::string optionsPath) {
+	this->optionsPath = optionsPath;
+	this->canCache = getOptionsFileKey(optionsPath, optionsFileKey);
+}
+
+size_t LevelOptionsIndex::addSection(std::string name, std::string text) {
+	Section& section = sections.emplace_back();
+	section.name = std::move(name);
+	section.text = std::move(text);
+	return sections.size() - 1;
+}
+
+void LevelOptionsIndex::markWarning() {
+	hadWarning = true;
+}
+
+void LevelOptionsIndex::writeCache() {
+	if (!canCache) {
+		return;
+	}
+	for (Section& section : sections) {
+		parseSection(section);
+	}
+	if (hadWarning) {
+		return;
+	}
+	std::vector<ImportRequest> requests;
+	for (const Section& section : sections) {
+		requests.push_back(section.options);
+	}
+	writeOptionsCache(optionsPath, optionsFileKey, requests);
+}
+
+void LevelOptionsIndex::parseSection(Section& section) {
+	std::call_once(section.parsed, [&]() {
+		IniDocument document(section.text.data(), section.text.size());
+		IniReader::parseLevelSection(
+			document.getSections().front(),
+			section.name,
+			section.options,
+			section.warnings
+		);
+		if (!section.warnings.empty()) {
+			hadWarning = true;
+		}
+	});
+}
+
+const ImportRequest& LevelOptionsIndex::resolve(
+		const ImportRequest& indexedRequest,
+		const std::function<void(ImportRequest&)>& complete) {
+	Section& section = sections[indexedRequest.optionsSection];
+	parseSection(section);
+	std::call_once(section.completed, [&]() {
+		// The level and land table were already worked out from the index.
+		section.request = indexedRequest;
+		section.request.levelFileName = section.options.levelFileName;
+		section.request.pakFileName = section.options.pakFileName;
+		section.request.levelOptions = section.options.levelOptions;
+		complete(section.request);
+	});
+	return section.request;
+}
+
+std::vector<std::string> LevelOptionsIndex::takeWarnings(size_t section) {
+	if (sections[section].warningsTaken.exchange(true)) {
+		return {};
+	}
+	return sections[section].warnings;
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,78 @@
+#pragma once
+#include "pch.h"
+#include "OptionsCache.h"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * The sections of a level_options.ini file, indexed at Init but completed,
+ * which finds their level files, only when their level is first needed.
+ * Each section is parsed and completed once, whichever thread asks for it
+ * first, and the result is kept.
+ *
+ * A section's options are parsed early only to rebuild the options cache,
+ * see writeCache, so launches after an edit skip indexing again.
+ */
+class LevelOptionsIndex {
+	public:
+		LevelOptionsIndex(std::string optionsPath);
+		LevelOptionsIndex(const LevelOptionsIndex&) = delete;
+		LevelOptionsIndex& operator=(const LevelOptionsIndex&) = delete;
+
+		/*
+		  Adds a section's name and raw text, and returns its index. Only
+		  call while indexing, before any section is resolved.
+		*/
+		size_t addSection(std::string name, std::string text);
+
+		/* Keeps the options from being cached, for warnings found indexing. */
+		void markWarning();
+
+		/*
+		  Parses every section and saves the options cache, unless a section
+		  has warnings. Call once indexing is done, before any section is
+		  resolved.
+		*/
+		void writeCache();
+
+		/*
+		  Returns the given indexed request with its section's options parsed
+		  in, after passing it to complete the first time. Thread safe.
+		*/
+		const ImportRequest& resolve(
+			const ImportRequest& indexedRequest,
+			const std::function<void(ImportRequest&)>& complete
+		);
+
+		/*
+		  Returns the warnings found parsing a resolved section. Each warning
+		  is only returned once.
+		*/
+		std::vector<std::string> takeWarnings(size_t section);
+
+	private:
+		struct Section {
+			std::string name;
+			std::string text;
+			std::once_flag parsed;
+			std::once_flag completed;
+			// The options as written in the file, for the options cache.
+			ImportRequest options;
+			// The indexed request with the options added and completed.
+			ImportRequest request;
+			std::vector<std::string> warnings;
+			std::atomic<bool> warningsTaken = false;
+		};
+
+		std::string optionsPath;
+		OptionsFileKey optionsFileKey;
+		bool canCache;
+		// A deque, as sections can't be moved.
+		std::deque<Section> sections;
+		std::atomic<bool> hadWarning = false;
+		void parseSection(Section& section);
+};
@@ -0,0 +1,118 @@
+/**
+ * LevelPreloader.cpp
+ *
+ * Description:
+ *    Loads the land tables and splines of imported levels in the background
+ *    at Init, so the level load hook does not read them from disk.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "LevelPreloader.h"
+#include <algorithm>
+
+LevelPreloader::~LevelPreloader() {
+	stop();
+}
+
+void LevelPreloader::start(size_t jobCount, LoadFunction load) {
+	stop();
+	if (jobCount == 0) {
+		return;
+	}
+	slots = std::make_unique<Slot[]>(jobCount);
+	slotCount = jobCount;
+	nextJob = 0;
+	cancelled = false;
+	// Leave a core for the game, which is still starting up.
+	size_t coreCount = std::thread::hardware_concurrency();
+	size_t threadCount = coreCount > 2 ? coreCount - 1 : 1;
+	threadCount = std::min(threadCount, jobCount);
+	// The workers share one copy of the load function.
+	auto sharedLoad = std::make_shared<LoadFunction>(std::move(load));
+	for (size_t i = 0; i < threadCount; i++) {
+		workers.emplace_back([this, sharedLoad]() { runWorker(*sharedLoad); });
+	}
+}
+
+std::unique_ptr<LevelResources> LevelPreloader::take(size_t job) {
+	if (job >= slotCount) {
+		return nullptr;
+	}
+	Slot& slot = slots[job];
+	// The worker stores its result before setting finished, so the result
+	// must only be taken once finished is seen set.
+	if (!slot.finished) {
+		printDebug("Waiting for the level to finish preloading.");
+		std::unique_lock<std::mutex> lock(finishedMutex);
+		finishedCondition.wait(lock, [&slot]() { return slot.finished.load(); });
+	}
+	return std::unique_ptr<LevelResources>(slot.resources.exchange(nullptr));
+}
+
+std::unique_ptr<LevelResources> LevelPreloader::takeFinished(size_t job) {
+	if (job >= slotCount || !slots[job].finished) {
+		return nullptr;
+	}
+	return std::unique_ptr<LevelResources>(slots[job].resources.exchange(nullptr));
+}
+
+size_t LevelPreloader::getJobCount() const {
+	return slotCount;
+}
+
+void LevelPreloader::stop() {
+	cancelled = true;
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+	for (size_t i = 0; i < slotCount; i++) {
+		delete slots[i].resources.exchange(nullptr);
+	}
+	slots.reset();
+	slotCount = 0;
+}
+
+void LevelPreloader::runWorker(const LoadFunction& load) {
+	while (!cancelled) {
+		size_t job = nextJob++;
+		if (job >= slotCount) {
+			return;
+		}
+		std::unique_ptr<LevelResources> resources;
+		// An exception escaping a thread would close the game, the level is
+		// loaded again on the hook instead.
+		try {
+			resources = load(job);
+		} catch (...) {
+			printDebug("(Warning) Preloading level " + std::to_string(job) +
+				" failed.");
+		}
+		slots[job].resources = resources.release();
+		{
+			std::lock_guard<std::mutex> lock(finishedMutex);
+			slots[job].finished = true;
+		}
+		finishedCondition.notify_all();
+	}
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,69 @@
+#pragma once
+#include "pch.h"
+#include "LevelResources.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Loads level resources on background threads so the level load hook only
+ * has to pick up the finished result. Each job's result is handed over with
+ * an atomic pointer swap, the hook only blocks if that job is still running.
+ */
+class LevelPreloader {
+	public:
+		/* Loads the resources of a job, or returns nullptr on failure. */
+		using LoadFunction =
+			std::function<std::unique_ptr<LevelResources>(size_t job)>;
+
+		LevelPreloader() = default;
+		LevelPreloader(const LevelPreloader&) = delete;
+		LevelPreloader& operator=(const LevelPreloader&) = delete;
+		~LevelPreloader();
+
+		/**
+		 * Starts loading jobs 0 to jobCount - 1 on a small pool of worker
+		 * threads. Any previous preload is stopped first.
+		 */
+		void start(size_t jobCount, LoadFunction load);
+
+		/**
+		 * Takes ownership of a job's resources, waiting for the job if it is
+		 * still running. Returns nullptr if the job failed, was already
+		 * taken, or was never started.
+		 */
+		std::unique_ptr<LevelResources> take(size_t job);
+
+		/**
+		 * Takes ownership of a job's resources if the job has finished,
+		 * without waiting. Returns nullptr otherwise.
+		 */
+		std::unique_ptr<LevelResources> takeFinished(size_t job);
+
+		/** The number of jobs started by the last call to start. */
+		size_t getJobCount() const;
+
+		/*
+		  Skips jobs that have not started, waits for running jobs, and frees
+		  every result that was not taken.
+		*/
+		void stop();
+
+	private:
+		struct Slot {
+			std::atomic<LevelResources*> resources{ nullptr };
+			std::atomic<bool> finished{ false };
+		};
+		std::unique_ptr<Slot[]> slots;
+		size_t slotCount = 0;
+		std::vector<std::thread> workers;
+		std::atomic<size_t> nextJob{ 0 };
+		std::atomic<bool> cancelled{ false };
+		std::mutex finishedMutex;
+		std::condition_variable finishedCondition;
+		void runWorker(const LoadFunction& load);
+};
@@ -0,0 +1,38 @@
+#pragma once
+#include "pch.h"
+#include "LevelArena.h"
+#include "SplinePool.h"
+#include "SplineSampler.h"
+#include "TexListCache.h"
+#include <memory>
+#include <vector>
+
+/*
+  The resources loaded from disk for one imported level. Owns everything it
+  points to, so a level's memory is freed by destroying its LevelResources.
+*/
+struct LevelResources {
+	// Owns the spline array. Declared first so it is destroyed last.
+	LevelArena arena;
+	// The pooled splines the spline array points at, shared with other
+	// levels using the same spline files.
+	std::vector<std::shared_ptr<SharedSpline>> sharedSplines;
+	// The texlist, shared with other levels using the same texture pack.
+	std::shared_ptr<SharedTexList> texList;
+	std::unique_ptr<LandTableInfo> landTableInfo;
+	// Points into landTableInfo, with the custom texlist attached.
+	LandTable* landTable = nullptr;
+	// A null terminated array of splines for LoadStagePaths, pointing into
+	// sharedSplines. Optional.
+	LoopHead** splines = nullptr;
+	// A sampler for each spline, in the same order.
+	std::vector<SplineSampler> splineSamplers;
+	// The index of the import request these resources were loaded for.
+	size_t requestIndex = 0;
+	// An estimate of the memory used, in bytes.
+	size_t memorySize = 0;
+
+	LevelResources() = default;
+	LevelResources(const LevelResources&) = delete;
+	LevelResources& operator=(const LevelResources&) = delete;
+};
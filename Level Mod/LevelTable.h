@@ -0,0 +1,83 @@
+#pragma once
+#include "pch.h"
+#include "PerfectHash.h"
+#include <array>
+#include <string_view>
+// Levels 0 to 71 are stages, each with a land table exported by the data
+// DLL. Chao gardens are imported by land table name instead.
+#define LEVEL_TABLE_SIZE 72
+#define LEVEL_SLOTS 1024
+
+/* A stage's land table export and SET file names, e.g. for level 13:
+   objLandTable0013 and set0013, whose SET files are set0013_s.bin and
+   set0013_u.bin. */
+struct LevelEntry {
+	LevelIDs levelID;
+	char landTableName[17];
+	char setFileStem[8];
+
+	constexpr std::string_view getLandTableName() const {
+		return std::string_view(landTableName, 16);
+	}
+	constexpr std::string_view getSetFileStem() const {
+		return std::string_view(setFileStem, 7);
+	}
+};
+
+constexpr std::array<LevelEntry, LEVEL_TABLE_SIZE> buildLevelTable() {
+	std::array<LevelEntry, LEVEL_TABLE_SIZE> table{};
+	for (int id = 0; id < LEVEL_TABLE_SIZE; id++) {
+		LevelEntry& entry = table[id];
+		entry.levelID = (LevelIDs)id;
+		const char digits[4] = {
+			(char)('0' + id / 1000 % 10),
+			(char)('0' + id / 100 % 10),
+			(char)('0' + id / 10 % 10),
+			(char)('0' + id % 10)
+		};
+		std::string_view prefix = "objLandTable";
+		for (size_t i = 0; i < prefix.size(); i++) {
+			entry.landTableName[i] = prefix[i];
+		}
+		entry.setFileStem[0] = 's';
+		entry.setFileStem[1] = 'e';
+		entry.setFileStem[2] = 't';
+		for (size_t i = 0; i < 4; i++) {
+			entry.landTableName[prefix.size() + i] = digits[i];
+			entry.setFileStem[3 + i] = digits[i];
+		}
+	}
+	return table;
+}
+
+inline constexpr std::array<LevelEntry, LEVEL_TABLE_SIZE> LEVEL_TABLE = buildLevelTable();
+
+constexpr std::string_view getLevelTableKey(const LevelEntry& entry) {
+	return entry.getLandTableName();
+}
+
+inline constexpr uint32_t LEVEL_SEED =
+	findPerfectHashSeed<LEVEL_SLOTS>(LEVEL_TABLE, getLevelTableKey);
+static_assert(LEVEL_SEED != UINT32_MAX, "No perfect hash found for the land "
+	"table names, raise LEVEL_SLOTS.");
+
+inline constexpr std::array<uint8_t, LEVEL_SLOTS> LEVEL_SLOT_TABLE =
+	buildPerfectHashSlots<LEVEL_SLOTS>(LEVEL_TABLE, LEVEL_SEED, getLevelTableKey);
+
+/* Returns the stage with the given level ID, or nullptr. */
+constexpr const LevelEntry* findLevel(LevelIDs levelID) {
+	return levelID >= 0 && levelID < LEVEL_TABLE_SIZE ? &LEVEL_TABLE[levelID] : nullptr;
+}
+
+/* Returns the stage with the given land table name, or nullptr. */
+constexpr const LevelEntry* findLevel(std::string_view landTableName) {
+	uint8_t slot = LEVEL_SLOT_TABLE[hashKey(landTableName, LEVEL_SEED) % LEVEL_SLOTS];
+	return slot != 0 && LEVEL_TABLE[slot - 1].getLandTableName() == landTableName
+		? &LEVEL_TABLE[slot - 1]
+		: nullptr;
+}
+
+static_assert(findLevel("objLandTable0013")->levelID == 13
+	&& findLevel((LevelIDs)3)->getSetFileStem() == "set0003"
+	&& findLevel("objLandTableChao") == nullptr,
+	"Level IDs and land table names must convert both ways.");
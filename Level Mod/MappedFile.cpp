@@ -0,0 +1,110 @@
+/**
+ * MappedFile.cpp
+ *
+ * Description:
+ *    Memory maps files so level files can be read without first being copied
+ *    into a buffer.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "MappedFile.h"
+#include <cstdint>
+
+MappedFile::MappedFile(const std::filesystem::path& path, bool copyOnWrite) {
+	this->copyOnWrite = copyOnWrite;
+	file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ,
+		nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return;
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0
+			|| (unsigned long long)size.QuadPart > SIZE_MAX) {
+		return;
+	}
+	mapping = CreateFileMappingA(file, nullptr,
+		copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		return;
+	}
+	view = (const char*)MapViewOfFile(mapping,
+		copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+	if (view != nullptr) {
+		fileSize = (size_t)size.QuadPart;
+	}
+}
+
+MappedFile::~MappedFile() {
+	if (view != nullptr) {
+		UnmapViewOfFile(view);
+	}
+	if (mapping != nullptr) {
+		CloseHandle(mapping);
+	}
+	if (file != INVALID_HANDLE_VALUE) {
+		CloseHandle(file);
+	}
+}
+
+bool MappedFile::isOpen() const {
+	return view != nullptr;
+}
+
+const char* MappedFile::data() const {
+	return view;
+}
+
+size_t MappedFile::size() const {
+	return fileSize;
+}
+
+char* MappedFile::mutableData() const {
+	return copyOnWrite ? const_cast<char*>(view) : nullptr;
+}
+
+MemoryStreamBuffer::MemoryStreamBuffer(const char* data, size_t size) {
+	// The get area is never written to, streambuf just requires char*.
+	char* begin = const_cast<char*>(data);
+	setg(begin, begin, begin + size);
+}
+
+MemoryStreamBuffer::pos_type MemoryStreamBuffer::seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode mode) {
+	if (!(mode & std::ios_base::in)) {
+		return pos_type(off_type(-1));
+	}
+	char* base = eback();
+	if (direction == std::ios_base::cur) {
+		offset += gptr() - base;
+	} else if (direction == std::ios_base::end) {
+		offset += egptr() - base;
+	}
+	if (offset < 0 || offset > egptr() - base) {
+		return pos_type(off_type(-1));
+	}
+	setg(base, base + offset, egptr());
+	return pos_type(offset);
+}
+
+MemoryStreamBuffer::pos_type MemoryStreamBuffer::seekpos(pos_type position, std::ios_base::openmode mode) {
+	return seekoff(off_type(position), std::ios_base::beg, mode);
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,55 @@
+#pragma once
+#include "pch.h"
+#include <filesystem>
+#include <streambuf>
+
+/**
+ * A read-only memory map of a file. Reading the mapped memory pages the file
+ * in straight from the OS file cache, without copying it into a buffer.
+ */
+class MappedFile {
+	public:
+		/**
+		 * Maps a file into memory.
+		 *
+		 * @param [path] - The file to map.
+		 * @param [copyOnWrite] - Whether the mapped memory may be written to.
+		 *     Written pages become private copies, the file never changes.
+		 */
+		MappedFile(const std::filesystem::path& path, bool copyOnWrite = false);
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile();
+
+		/** Whether the file was mapped. Empty files can't be mapped. */
+		bool isOpen() const;
+		const char* data() const;
+		size_t size() const;
+
+		/* The mapped memory if mapped copy on write, otherwise nullptr. */
+		char* mutableData() const;
+
+	private:
+		bool copyOnWrite;
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = nullptr;
+		const char* view = nullptr;
+		size_t fileSize = 0;
+};
+
+/**
+ * A std::streambuf reading from memory it does not own, such as a
+ * MappedFile, so stream based loaders can read it without a copy.
+ */
+class MemoryStreamBuffer : public std::streambuf {
+	public:
+		MemoryStreamBuffer(const char* data, size_t size);
+
+	protected:
+		pos_type seekoff(
+			off_type offset,
+			std::ios_base::seekdir direction,
+			std::ios_base::openmode mode
+		) override;
+		pos_type seekpos(pos_type position, std::ios_base::openmode mode) override;
+};
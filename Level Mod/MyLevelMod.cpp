@@ -33,6 +33,7 @@ extern "C" {
 
 	// Runs when the game closes. Required for My Level Mod.
 	__declspec(dllexport) void __cdecl OnExit() {
+		myLevelModExit();
 		myLevelMod->free();
 	}
 
@@ -0,0 +1,94 @@
+#pragma once
+#include "pch.h"
+#include "PerfectHash.h"
+#include "ValueParser.h"
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * Describes one key of a level_options.ini section: how its value is parsed,
+ * and which member of the ImportRequest it sets.
+ */
+struct OptionDescriptor {
+	std::string_view key;
+	// Parses a value into the request. Returns why the value is invalid, or
+	// nullptr if it was applied.
+	const char* (*apply)(std::string_view value, ImportRequest& request);
+	// Applied when the key is missing, or nullptr to leave the member alone.
+	const char* defaultValue;
+};
+
+template <typename T>
+T& optionTarget(ImportRequest& request, T ImportRequest::* member) {
+	return request.*member;
+}
+
+template <typename T>
+T& optionTarget(ImportRequest& request, T LevelOptions::* member) {
+	return request.levelOptions.*member;
+}
+
+template <auto Member>
+const char* applyString(std::string_view value, ImportRequest& request) {
+	optionTarget(request, Member) = std::string(value);
+	return nullptr;
+}
+
+template <auto Member>
+const char* applyList(std::string_view value, ImportRequest& request) {
+	optionTarget(request, Member) = splitList(value);
+	return nullptr;
+}
+
+template <auto Member, auto Parse>
+const char* applyParsed(std::string_view value, ImportRequest& request) {
+	auto result = Parse(value);
+	if (result) {
+		using Target = std::remove_reference_t<decltype(optionTarget(request, Member))>;
+		optionTarget(request, Member) = (Target)result.value;
+	}
+	return result.error;
+}
+
+/* Every key a level_options.ini section may use. */
+constexpr OptionDescriptor OPTION_SCHEMA[] = {
+	{ "level_id", applyParsed<&ImportRequest::levelID, parseInt>, nullptr },
+	{ "land_table_name", applyString<&ImportRequest::landTableName>, nullptr },
+	{ "level_file_name", applyString<&ImportRequest::levelFileName>, nullptr },
+	{ "pak_file_name", applyString<&ImportRequest::pakFileName>, nullptr },
+	{ "spline_file_names", applyList<&LevelOptions::splineFileNames>, nullptr },
+	{ "recompute_spline_metrics", applyParsed<&LevelOptions::recomputeSplineMetrics, parseBool>, nullptr },
+	{ "simple_death_plane", applyParsed<&LevelOptions::simpleDeathPlane, parseDeathPlane>, nullptr },
+	{ "spawn_coordinates", applyParsed<&LevelOptions::startPosition, parsePosition>, "0,0,0" },
+	{ "victory_coordinates", applyParsed<&LevelOptions::endPosition, parsePosition>, "0,0,0" },
+};
+constexpr size_t OPTION_COUNT = sizeof(OPTION_SCHEMA) / sizeof(OPTION_SCHEMA[0]);
+static_assert(OPTION_COUNT <= 32, "Seen options are tracked in a 32 bit mask.");
+
+/*
+  Keys are dispatched through a perfect hash, see PerfectHash.h, so looking
+  up a key costs the same however many options there are.
+*/
+#define OPTION_SLOTS 32
+
+constexpr std::string_view getOptionKey(const OptionDescriptor& option) {
+	return option.key;
+}
+
+constexpr uint32_t OPTION_SEED =
+	findPerfectHashSeed<OPTION_SLOTS>(OPTION_SCHEMA, getOptionKey);
+static_assert(OPTION_SEED != UINT32_MAX, "No perfect hash found for the option "
+	"keys, raise OPTION_SLOTS.");
+
+constexpr std::array<uint8_t, OPTION_SLOTS> OPTION_SLOT_TABLE =
+	buildPerfectHashSlots<OPTION_SLOTS>(OPTION_SCHEMA, OPTION_SEED, getOptionKey);
+
+/* Returns the index of the option with the given key, or -1 if unknown. */
+constexpr int findOption(std::string_view key) {
+	uint8_t slot = OPTION_SLOT_TABLE[hashKey(key, OPTION_SEED) % OPTION_SLOTS];
+	return slot != 0 && OPTION_SCHEMA[slot - 1].key == key ? slot - 1 : -1;
+}
+static_assert(findOption("level_id") == 0 && findOption("unknown_key") == -1,
+	"Option keys must dispatch to their own descriptor.");
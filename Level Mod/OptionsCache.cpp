@@ -0,0 +1,176 @@
+/**
+ * OptionsCache.cpp
+ *
+ * Description:
+ *    A compact binary copy of the parsed level_options.ini, saved next to it
+ *    as level_options.ini.cache. The cache is keyed on the options file's
+ *    size, modification time and a hash of its contents, and is rebuilt
+ *    whenever any of them change.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "OptionsCache.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+#define OPTIONS_CACHE_MAGIC 0x4F4D4C4D // "MLMO"
+// Increase when the layout of ImportRequest or the cache changes.
+#define OPTIONS_CACHE_VERSION 2
+
+bool getOptionsFileKey(const std::string& optionsPath, OptionsFileKey& key) {
+	std::error_code error;
+	auto modifiedTime = std::filesystem::last_write_time(optionsPath, error);
+	if (error) {
+		return false;
+	}
+	MappedFile optionsFile(optionsPath);
+	if (!optionsFile.isOpen()) {
+		return false;
+	}
+	key.size = optionsFile.size();
+	key.modifiedTime = modifiedTime.time_since_epoch().count();
+	key.hash = hashContents(optionsFile.data(), optionsFile.size());
+	return true;
+}
+
+/* Reads values from a cache file, failing on reads past its end. */
+class CacheReader {
+	public:
+		CacheReader(const char* data, size_t size)
+			: position(data), end(data + size) {}
+
+		template <typename T>
+		T read() {
+			T value{};
+			if (ok && (size_t)(end - position) >= sizeof(T)) {
+				std::memcpy(&value, position, sizeof(T));
+				position += sizeof(T);
+			} else {
+				ok = false;
+			}
+			return value;
+		}
+
+		std::string readString() {
+			uint32_t length = read<uint32_t>();
+			if (!ok || (size_t)(end - position) < length) {
+				ok = false;
+				return std::string();
+			}
+			std::string value(position, length);
+			position += length;
+			return value;
+		}
+
+		bool isOk() const {
+			return ok;
+		}
+
+	private:
+		const char* position;
+		const char* end;
+		bool ok = true;
+};
+
+bool readOptionsCache(const std::string& optionsPath, std::vector<ImportRequest>& requests) {
+	MappedFile cacheFile(optionsPath + ".cache");
+	OptionsFileKey key;
+	if (!cacheFile.isOpen() || !getOptionsFileKey(optionsPath, key)) {
+		return false;
+	}
+	CacheReader reader(cacheFile.data(), cacheFile.size());
+	if (reader.read<uint32_t>() != OPTIONS_CACHE_MAGIC
+			|| reader.read<uint32_t>() != OPTIONS_CACHE_VERSION
+			|| reader.read<uint64_t>() != key.size
+			|| reader.read<int64_t>() != key.modifiedTime
+			|| reader.read<uint64_t>() != key.hash) {
+		return false;
+	}
+	uint32_t requestCount = reader.read<uint32_t>();
+	std::vector<ImportRequest> cachedRequests;
+	for (uint32_t i = 0; i < requestCount && reader.isOk(); i++) {
+		ImportRequest request;
+		request.levelID = (LevelIDs)reader.read<int32_t>();
+		request.landTableName = reader.readString();
+		request.levelFileName = reader.readString();
+		request.pakFileName = reader.readString();
+		LevelOptions& options = request.levelOptions;
+		options.startPosition = reader.read<NJS_VECTOR>();
+		options.endPosition = reader.read<NJS_VECTOR>();
+		options.simpleDeathPlane = reader.read<float>();
+		uint32_t splineCount = reader.read<uint32_t>();
+		for (uint32_t j = 0; j < splineCount && reader.isOk(); j++) {
+			options.splineFileNames.push_back(reader.readString());
+		}
+		options.recomputeSplineMetrics = reader.read<uint8_t>() != 0;
+		cachedRequests.push_back(std::move(request));
+	}
+	if (!reader.isOk()) {
+		return false;
+	}
+	requests = std::move(cachedRequests);
+	return true;
+}
+
+void writeOptionsCache(const std::string& optionsPath, const OptionsFileKey& key, const std::vector<ImportRequest>& requests) {
+	std::string buffer;
+	auto write = [&buffer](const auto& value) {
+		buffer.append((const char*)&value, sizeof(value));
+	};
+	auto writeString = [&buffer, &write](const std::string& value) {
+		write((uint32_t)value.size());
+		buffer.append(value);
+	};
+	write((uint32_t)OPTIONS_CACHE_MAGIC);
+	write((uint32_t)OPTIONS_CACHE_VERSION);
+	write(key.size);
+	write(key.modifiedTime);
+	write(key.hash);
+	write((uint32_t)requests.size());
+	for (const ImportRequest& request : requests) {
+		write((int32_t)request.levelID);
+		writeString(request.landTableName);
+		writeString(request.levelFileName);
+		writeString(request.pakFileName);
+		const LevelOptions& options = request.levelOptions;
+		write(options.startPosition);
+		write(options.endPosition);
+		write(options.simpleDeathPlane);
+		write((uint32_t)options.splineFileNames.size());
+		for (const std::string& splineFileName : options.splineFileNames) {
+			writeString(splineFileName);
+		}
+		write((uint8_t)options.recomputeSplineMetrics);
+	}
+	std::ofstream cacheFile(optionsPath + ".cache",
+		std::ios::binary | std::ios::trunc);
+	cacheFile.write(buffer.data(), buffer.size());
+	if (!cacheFile) {
+		printDebug("(Warning) Could not save the level options cache.");
+	}
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,36 @@
+#pragma once
+#include "pch.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* The options file a cache was written for. */
+struct OptionsFileKey {
+	uint64_t size = 0;
+	int64_t modifiedTime = 0;
+	uint64_t hash = 0;
+};
+
+/* Reads the size, modification time and hash of an options file. */
+bool getOptionsFileKey(const std::string& optionsPath, OptionsFileKey& key);
+
+/*
+  Reads the import requests saved by writeOptionsCache for an options file.
+  Fails if there is no cache, or if the options file's size, modification
+  time or contents changed since the cache was written.
+*/
+bool readOptionsCache(
+	const std::string& optionsPath,
+	std::vector<ImportRequest>& requests
+);
+
+/*
+  Saves parsed import requests next to the options file they came from, so
+  the next launch can skip parsing it. The key must be read before the
+  requests were parsed, so later edits to the file invalidate the cache.
+*/
+void writeOptionsCache(
+	const std::string& optionsPath,
+	const OptionsFileKey& key,
+	const std::vector<ImportRequest>& requests
+);
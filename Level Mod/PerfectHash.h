@@ -0,0 +1,57 @@
+#pragma once
+#include "pch.h"
+#include <array>
+#include <cstdint>
+#include <string_view>
+// How many seeds to try before giving up on a table. Raise the table's slot
+// count rather than this, if a static_assert fails.
+#define PERFECT_HASH_MAX_SEED 100000
+
+/*
+  Compile-time perfect hashing for fixed sets of string keys. A seeded FNV-1a
+  hash is tried with increasing seeds until every key lands in its own slot,
+  all in constexpr, so a lookup costs one hash and one string compare.
+*/
+
+constexpr uint32_t hashKey(std::string_view key, uint32_t seed) {
+	uint32_t hash = 2166136261u ^ seed;
+	for (char c : key) {
+		hash = (hash ^ (uint8_t)c) * 16777619u;
+	}
+	return hash;
+}
+
+/*
+  Returns the first seed that sends every item's key to its own slot, or
+  UINT32_MAX if there is none.
+*/
+template <size_t Slots, typename Items, typename GetKey>
+constexpr uint32_t findPerfectHashSeed(const Items& items, GetKey getKey) {
+	for (uint32_t seed = 0; seed < PERFECT_HASH_MAX_SEED; seed++) {
+		bool usedSlots[Slots] = {};
+		bool collided = false;
+		for (const auto& item : items) {
+			uint32_t slot = hashKey(getKey(item), seed) % Slots;
+			collided = collided || usedSlots[slot];
+			usedSlots[slot] = true;
+		}
+		if (!collided) {
+			return seed;
+		}
+	}
+	return UINT32_MAX;
+}
+
+/* Maps each slot to its item's index plus one, 0 meaning no item. */
+template <size_t Slots, typename Items, typename GetKey>
+constexpr std::array<uint8_t, Slots> buildPerfectHashSlots(
+		const Items& items,
+		uint32_t seed,
+		GetKey getKey) {
+	std::array<uint8_t, Slots> slots{};
+	uint8_t index = 0;
+	for (const auto& item : items) {
+		slots[hashKey(getKey(item), seed) % Slots] = ++index;
+	}
+	return slots;
+}
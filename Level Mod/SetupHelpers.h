@@ -1,20 +1,17 @@
 #pragma once
 
 #include "pch.h"
+#include "AssetIndex.h"
 #include "IniReader.h"
 #include "LevelImporter.h"
-
-/*
-  Checks the internet for an update to My Level Mod and saves a 
-  notification file in the mod folder if an update is detected.
-*/
-void checkForUpdate(const char* modFolderPath);
+#include "UpdateCheck.h"
 
 /*
   Checks for and fixes incorrect file placements in the mod folder. If any
-  fixes occur, a restart will be required.
+  fixes occur, a restart will be required. The asset index is refreshed after
+  files are moved or created.
 */
-void fixFileStructure(const char* modFolderPath, LevelIDs levelID);
+void fixFileStructure(AssetIndex& assetIndex, LevelIDs levelID);
 
 /*
   Sets up My Level Mod by reading from level_options.ini and setting up level
@@ -22,5 +19,5 @@ void fixFileStructure(const char* modFolderPath, LevelIDs levelID);
 */
 void myLevelModInit(const char* modFolderPath, LevelImporter* levelImporter);
 
-/** Helper function for checkForUpdate(). */
-int writer(char* data, size_t size, size_t nmemb, std::string* buffer);
+/* Stops any background work started by myLevelModInit. */
+void myLevelModExit();
@@ -0,0 +1,224 @@
+/**
+ * SplineMetrics.cpp
+ *
+ * Description:
+ *    Derives the distances and rotations of spline points from their
+ *    positions, for the recompute_spline_metrics level option.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "SplineMetrics.h"
+#include <cmath>
+#include <vector>
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define SPLINE_USE_SSE
+#include <emmintrin.h>
+#endif
+// MSVC allows AVX intrinsics in any build, and GCC and Clang in functions
+// targeting AVX, so AVX is chosen at runtime.
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define SPLINE_USE_AVX
+#define SPLINE_AVX_TARGET
+#include <immintrin.h>
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define SPLINE_USE_AVX
+#define SPLINE_AVX_TARGET __attribute__((target("avx")))
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+// Ninja angles split a full turn into 0x10000 steps.
+#define RADIANS_TO_ANGLE (65536.0 / (2 * 3.14159265358979323846))
+
+/*
+  A spline's segments in structure of arrays form, padded to a multiple of 8
+  so the vector loops never need a tail.
+*/
+struct SegmentArrays {
+	size_t count;
+	std::vector<float> buffer;
+	float* dx;
+	float* dy;
+	float* dz;
+	float* length;
+	float* horizontalLength;
+
+	SegmentArrays(size_t count) {
+		this->count = count;
+		size_t stride = (count + 7) / 8 * 8;
+		this->buffer.resize(stride * 5);
+		this->dx = buffer.data();
+		this->dy = dx + stride;
+		this->dz = dy + stride;
+		this->length = dz + stride;
+		this->horizontalLength = length + stride;
+	}
+};
+
+static void computeLengthsScalar(SegmentArrays& segments) {
+	for (size_t i = 0; i < segments.count; i++) {
+		float horizontal = segments.dx[i] * segments.dx[i] + segments.dz[i] * segments.dz[i];
+		float squared = horizontal + segments.dy[i] * segments.dy[i];
+		segments.length[i] = std::sqrt(squared);
+		segments.horizontalLength[i] = std::sqrt(horizontal);
+	}
+}
+
+#ifdef SPLINE_USE_SSE
+static void computeLengthsSse(SegmentArrays& segments) {
+	for (size_t i = 0; i < segments.count; i += 4) {
+		__m128 dx = _mm_loadu_ps(segments.dx + i);
+		__m128 dy = _mm_loadu_ps(segments.dy + i);
+		__m128 dz = _mm_loadu_ps(segments.dz + i);
+		__m128 horizontal = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz));
+		__m128 squared = _mm_add_ps(horizontal, _mm_mul_ps(dy, dy));
+		_mm_storeu_ps(segments.length + i, _mm_sqrt_ps(squared));
+		_mm_storeu_ps(segments.horizontalLength + i, _mm_sqrt_ps(horizontal));
+	}
+}
+#endif
+
+#ifdef SPLINE_USE_AVX
+SPLINE_AVX_TARGET static void computeLengthsAvx(SegmentArrays& segments) {
+	for (size_t i = 0; i < segments.count; i += 8) {
+		__m256 dx = _mm256_loadu_ps(segments.dx + i);
+		__m256 dy = _mm256_loadu_ps(segments.dy + i);
+		__m256 dz = _mm256_loadu_ps(segments.dz + i);
+		__m256 horizontal = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dz, dz));
+		__m256 squared = _mm256_add_ps(horizontal, _mm256_mul_ps(dy, dy));
+		_mm256_storeu_ps(segments.length + i, _mm256_sqrt_ps(squared));
+		_mm256_storeu_ps(segments.horizontalLength + i, _mm256_sqrt_ps(horizontal));
+	}
+}
+
+/* Whether the CPU and OS both support AVX. */
+static bool hasAvx() {
+#ifdef __AVX__
+	return true;
+#elif defined(__GNUC__)
+	return __builtin_cpu_supports("avx");
+#else
+	int info[4];
+	__cpuid(info, 1);
+	bool osSavesAvx = (info[2] & (1 << 27)) != 0;
+	bool cpuHasAvx = (info[2] & (1 << 28)) != 0;
+	return osSavesAvx && cpuHasAvx && (_xgetbv(0) & 6) == 6;
+#endif
+}
+#endif
+
+/* The fastest path this build and CPU can run. */
+static SplineMetricsPath findFastestPath() {
+#ifdef SPLINE_USE_AVX
+	if (hasAvx()) {
+		return SplineMetricsPath::Avx;
+	}
+#endif
+#ifdef SPLINE_USE_SSE
+	return SplineMetricsPath::Sse;
+#else
+	return SplineMetricsPath::Scalar;
+#endif
+}
+
+bool canUseSplineMetricsPath(SplineMetricsPath path) {
+	switch (path) {
+#ifdef SPLINE_USE_AVX
+		case SplineMetricsPath::Avx:
+			return hasAvx();
+#endif
+#ifdef SPLINE_USE_SSE
+		case SplineMetricsPath::Sse:
+			return true;
+#endif
+		case SplineMetricsPath::Scalar:
+			return true;
+		default:
+			return false;
+	}
+}
+
+static void computeLengths(SegmentArrays& segments, SplineMetricsPath path) {
+	switch (path) {
+#ifdef SPLINE_USE_AVX
+		case SplineMetricsPath::Avx:
+			computeLengthsAvx(segments);
+			return;
+#endif
+#ifdef SPLINE_USE_SSE
+		case SplineMetricsPath::Sse:
+			computeLengthsSse(segments);
+			return;
+#endif
+		default:
+			computeLengthsScalar(segments);
+			return;
+	}
+}
+
+void recomputeSplineMetrics(LoopHead& spline) {
+	static const SplineMetricsPath fastestPath = findFastestPath();
+	recomputeSplineMetrics(spline, fastestPath);
+}
+
+bool recomputeSplineMetrics(LoopHead& spline, SplineMetricsPath path) {
+	if (!canUseSplineMetricsPath(path)) {
+		return false;
+	}
+	LoopPoint* points = spline.Points;
+	size_t pointCount = spline.Count > 0 ? spline.Count : 0;
+	if (pointCount < 2) {
+		if (pointCount == 1) {
+			points[0].Distance = 0;
+		}
+		spline.TotalDistance = 0;
+		return true;
+	}
+	SegmentArrays segments(pointCount - 1);
+	for (size_t i = 0; i < segments.count; i++) {
+		segments.dx[i] = points[i + 1].Position.x - points[i].Position.x;
+		segments.dy[i] = points[i + 1].Position.y - points[i].Position.y;
+		segments.dz[i] = points[i + 1].Position.z - points[i].Position.z;
+	}
+	computeLengths(segments, path);
+
+	// Summed in order, so the total is the same whichever path ran.
+	float totalDistance = 0;
+	for (size_t i = 0; i < segments.count; i++) {
+		LoopPoint& point = points[i];
+		point.Distance = segments.length[i];
+		totalDistance += segments.length[i];
+		// Rotating (0, 0, 1) by XRot, then YRot, points along the segment.
+		point.XRot = (int16_t)(int)(std::atan2(-segments.dy[i],
+			segments.horizontalLength[i]) * RADIANS_TO_ANGLE);
+		point.YRot = (int16_t)(int)(std::atan2(segments.dx[i],
+			segments.dz[i]) * RADIANS_TO_ANGLE);
+	}
+	LoopPoint& lastPoint = points[pointCount - 1];
+	lastPoint.Distance = 0;
+	lastPoint.XRot = points[pointCount - 2].XRot;
+	lastPoint.YRot = points[pointCount - 2].YRot;
+	spline.TotalDistance = totalDistance;
+	return true;
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,31 @@
+#pragma once
+#include "pch.h"
+
+/**
+ * Recomputes a spline's metrics from the positions of its points, for
+ * splines whose hand entered values no longer match their points. Each
+ * point's Distance becomes the length of the segment to the next point, and
+ * its rotations point along that segment. The last point keeps the
+ * rotations of the one before it, with a Distance of 0. TotalDistance
+ * becomes the sum of the segment lengths.
+ *
+ * Segment lengths are computed 8 or 4 at a time with AVX or SSE, whichever
+ * the CPU supports, and give the same results as the scalar fallback.
+ */
+void recomputeSplineMetrics(LoopHead& spline);
+
+/* The ways recomputeSplineMetrics can compute segment lengths. */
+enum class SplineMetricsPath {
+	Scalar,
+	Sse,
+	Avx
+};
+
+/* Whether this build and CPU can run a path. */
+bool canUseSplineMetricsPath(SplineMetricsPath path);
+
+/*
+  Recomputes a spline's metrics with the given path, for comparing the paths.
+  Returns false, leaving the spline as is, if the path can't run here.
+*/
+bool recomputeSplineMetrics(LoopHead& spline, SplineMetricsPath path);
@@ -0,0 +1,89 @@
+/**
+ * SplinePool.cpp
+ *
+ * Description:
+ *    Parses each spline file once and shares it between the levels that use
+ *    it. See SplinePool.h.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "SplinePool.h"
+#include "IniReader.h"
+#include "MappedFile.h"
+#include <iterator>
+
+std::shared_ptr<SharedSpline> SplinePool::get(const AssetEntry& file, bool recomputeMetrics, const LoadFunction& load) {
+	std::string path = file.path.string();
+	ContentKey key;
+	key.recomputeMetrics = recomputeMetrics;
+	bool hashed;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto fileKey = files.find(path);
+		hashed = fileKey != files.end()
+			&& fileKey->second.modifiedTime == file.modifiedTime
+			&& fileKey->second.size == file.size;
+		if (hashed) {
+			key = fileKey->second.contentKey;
+			key.recomputeMetrics = recomputeMetrics;
+		}
+	}
+	// Files are only mapped and hashed the first time they are seen, or
+	// after they changed.
+	if (!hashed) {
+		MappedFile mappedFile(file.path);
+		if (!mappedFile.isOpen()) {
+			printDebug("(Warning) Could not read the spline found at " +
+				path + ".");
+			return nullptr;
+		}
+		key.hash = hashContents(mappedFile.data(), mappedFile.size());
+		key.size = mappedFile.size();
+	}
+	std::shared_ptr<SharedSpline> sharedSpline;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!hashed) {
+			files[path] = { file.modifiedTime, file.size, key };
+		}
+		auto entry = splines.find(key);
+		if (entry != splines.end()) {
+			sharedSpline = entry->second.lock();
+		}
+		if (sharedSpline == nullptr) {
+			// Entries of splines no level is reading anymore are dropped, as
+			// they would keep their shared_ptr control blocks allocated.
+			for (auto it = splines.begin(); it != splines.end();) {
+				it = it->second.expired() ? splines.erase(it) : std::next(it);
+			}
+			sharedSpline = std::make_shared<SharedSpline>(SPLINE_ARENA_CHUNK_SIZE);
+			splines[key] = sharedSpline;
+		}
+	}
+	// Parsed outside the lock, so other files can be parsed meanwhile. Any
+	// other level asking for the same contents waits for this parse.
+	std::call_once(sharedSpline->loaded, [&]() {
+		sharedSpline->spline = load(sharedSpline->arena);
+	});
+	return sharedSpline;
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,75 @@
+#pragma once
+#include "pch.h"
+#include "AssetIndex.h"
+#include "LevelArena.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/* A spline shared by every loaded level that uses a file with its contents. */
+struct SharedSpline {
+	// Owns the spline and its points, which are one block, or the mapped
+	// .sa2path file they are read from.
+	LevelArena arena;
+	// The parsed spline, or nullptr if the file is not a valid spline.
+	LoopHead* spline = nullptr;
+	std::once_flag loaded;
+
+	SharedSpline(size_t chunkSize) : arena(chunkSize) {}
+};
+
+/**
+ * Parses each spline file once, and shares the result between every level
+ * that uses it, including preloaded and cached levels. Levels point their
+ * spline arrays straight at the pooled splines. Splines are keyed by a hash
+ * of their file's contents, so copies of one spline file are only parsed
+ * once too. A file is only hashed the first time it is seen with its size
+ * and time. A spline is freed once no level holds it anymore. Safe to use
+ * from the preloader's threads.
+ */
+class SplinePool {
+	public:
+		using LoadFunction = std::function<LoopHead*(LevelArena& arena)>;
+
+		/**
+		 * Returns the spline for a file, calling load to parse it into the
+		 * shared spline's arena if no level holds its contents yet. Splines
+		 * with recomputed metrics are pooled apart from the ones as written,
+		 * as levels never change a spline another level uses.
+		 * Returns nullptr if the file can't be read.
+		 */
+		std::shared_ptr<SharedSpline> get(
+			const AssetEntry& file,
+			bool recomputeMetrics,
+			const LoadFunction& load
+		);
+
+	private:
+		struct ContentKey {
+			uint64_t hash;
+			size_t size;
+			bool recomputeMetrics;
+			bool operator==(const ContentKey& other) const {
+				return hash == other.hash && size == other.size
+					&& recomputeMetrics == other.recomputeMetrics;
+			}
+		};
+		struct ContentKeyHash {
+			size_t operator()(const ContentKey& key) const {
+				return (size_t)(key.hash ^ key.size) + key.recomputeMetrics;
+			}
+		};
+		// The contents of a file, as of the size and time it had when hashed.
+		struct FileKey {
+			std::filesystem::file_time_type modifiedTime;
+			uintmax_t size;
+			ContentKey contentKey;
+		};
+		std::mutex mutex;
+		// Keyed by file path.
+		std::unordered_map<std::string, FileKey> files;
+		std::unordered_map<ContentKey, std::weak_ptr<SharedSpline>, ContentKeyHash> splines;
+};
@@ -0,0 +1,163 @@
+/**
+ * SplineSampler.cpp
+ *
+ * Description:
+ *    Distance and nearest point lookups for loaded splines, through a table
+ *    of distances and a k-d tree of points. See SplineSampler.h.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "SplineSampler.h"
+#include <algorithm>
+#include <cmath>
+
+static float getAxis(const NJS_VECTOR& vector, int axis) {
+	return axis == 0 ? vector.x : axis == 1 ? vector.y : vector.z;
+}
+
+static float getSquaredDistance(const NJS_VECTOR& a, const NJS_VECTOR& b) {
+	float dx = a.x - b.x;
+	float dy = a.y - b.y;
+	float dz = a.z - b.z;
+	return dx * dx + dy * dy + dz * dz;
+}
+
+SplineSampler::SplineSampler(const LoopHead& spline) {
+	this->spline = &spline;
+	size_t pointCount = spline.Count > 0 ? spline.Count : 0;
+	this->pointDistances.resize(pointCount);
+	for (size_t i = 1; i < pointCount; i++) {
+		pointDistances[i] = pointDistances[i - 1] + std::sqrt(getSquaredDistance(
+			spline.Points[i].Position, spline.Points[i - 1].Position));
+	}
+	this->pointTree.resize(pointCount);
+	for (size_t i = 0; i < pointCount; i++) {
+		pointTree[i] = (uint32_t)i;
+	}
+	buildTree(0, pointCount, 0);
+}
+
+const LoopHead& SplineSampler::getSpline() const {
+	return *spline;
+}
+
+float SplineSampler::getLength() const {
+	return pointDistances.empty() ? 0 : pointDistances.back();
+}
+
+float SplineSampler::getPointDistance(size_t pointIndex) const {
+	return pointDistances[pointIndex];
+}
+
+size_t SplineSampler::findSegment(float distance) const {
+	if (pointDistances.size() < 2) {
+		return 0;
+	}
+	// The last point starting a segment is the one before the end.
+	auto segmentEnd = std::upper_bound(pointDistances.begin() + 1,
+		pointDistances.end() - 1, distance);
+	return segmentEnd - pointDistances.begin() - 1;
+}
+
+NJS_VECTOR SplineSampler::sample(float distance) const {
+	if (pointDistances.empty()) {
+		return { 0, 0, 0 };
+	}
+	if (pointDistances.size() == 1) {
+		return spline->Points[0].Position;
+	}
+	size_t segment = findSegment(distance);
+	const NJS_VECTOR& start = spline->Points[segment].Position;
+	const NJS_VECTOR& end = spline->Points[segment + 1].Position;
+	float segmentLength = pointDistances[segment + 1] - pointDistances[segment];
+	float t = segmentLength > 0
+		? (distance - pointDistances[segment]) / segmentLength
+		: 0;
+	t = std::min(std::max(t, 0.0f), 1.0f);
+	return {
+		start.x + (end.x - start.x) * t,
+		start.y + (end.y - start.y) * t,
+		start.z + (end.z - start.z) * t
+	};
+}
+
+size_t SplineSampler::findNearestPoint(const NJS_VECTOR& position) const {
+	size_t nearestPoint = SIZE_MAX;
+	float nearestSquaredDistance = INFINITY;
+	findNearestPoint(0, pointTree.size(), 0, position,
+		nearestPoint, nearestSquaredDistance);
+	return nearestPoint;
+}
+
+void SplineSampler::buildTree(size_t begin, size_t end, int axis) {
+	if (end - begin < 2) {
+		return;
+	}
+	size_t middle = begin + (end - begin) / 2;
+	std::nth_element(pointTree.begin() + begin, pointTree.begin() + middle,
+		pointTree.begin() + end, [this, axis](uint32_t a, uint32_t b) {
+			return getAxis(spline->Points[a].Position, axis)
+				< getAxis(spline->Points[b].Position, axis);
+		});
+	buildTree(begin, middle, (axis + 1) % 3);
+	buildTree(middle + 1, end, (axis + 1) % 3);
+}
+
+void SplineSampler::findNearestPoint(
+		size_t begin,
+		size_t end,
+		int axis,
+		const NJS_VECTOR& position,
+		size_t& nearestPoint,
+		float& nearestSquaredDistance) const {
+	if (begin >= end) {
+		return;
+	}
+	size_t middle = begin + (end - begin) / 2;
+	uint32_t pointIndex = pointTree[middle];
+	const NJS_VECTOR& point = spline->Points[pointIndex].Position;
+	float squaredDistance = getSquaredDistance(point, position);
+	if (squaredDistance < nearestSquaredDistance) {
+		nearestPoint = pointIndex;
+		nearestSquaredDistance = squaredDistance;
+	}
+	// Search the side of the split holding the position first, then the
+	// other side only if it could hold a closer point.
+	float offset = getAxis(position, axis) - getAxis(point, axis);
+	int nextAxis = (axis + 1) % 3;
+	if (offset < 0) {
+		findNearestPoint(begin, middle, nextAxis, position,
+			nearestPoint, nearestSquaredDistance);
+		if (offset * offset < nearestSquaredDistance) {
+			findNearestPoint(middle + 1, end, nextAxis, position,
+				nearestPoint, nearestSquaredDistance);
+		}
+	} else {
+		findNearestPoint(middle + 1, end, nextAxis, position,
+			nearestPoint, nearestSquaredDistance);
+		if (offset * offset < nearestSquaredDistance) {
+			findNearestPoint(begin, middle, nextAxis, position,
+				nearestPoint, nearestSquaredDistance);
+		}
+	}
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,64 @@
+#pragma once
+#include "pch.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Answers questions about a loaded spline for custom code, such as where a
+ * distance along the rail is, or which of its points is closest to the
+ * player. Everything is built once with the level, so queries never
+ * allocate and take O(log n) time.
+ *
+ * Distances are measured along the points' positions, so they hold even
+ * when a spline's Distance values are stale.
+ */
+class SplineSampler {
+	public:
+		/* The spline must outlive the sampler. */
+		SplineSampler(const LoopHead& spline);
+
+		const LoopHead& getSpline() const;
+
+		/** The length of the spline, measured through its points. */
+		float getLength() const;
+
+		/** The distance along the spline of the point at the given index. */
+		float getPointDistance(size_t pointIndex) const;
+
+		/**
+		 * Returns the index of the point starting the segment a distance
+		 * along the spline falls in. Distances outside the spline are
+		 * clamped to its ends.
+		 */
+		size_t findSegment(float distance) const;
+
+		/**
+		 * Returns the position a distance along the spline, between the
+		 * points around it. Distances outside the spline are clamped to its
+		 * ends.
+		 */
+		NJS_VECTOR sample(float distance) const;
+
+		/**
+		 * Returns the index of the spline point closest to a position, or
+		 * SIZE_MAX if the spline has no points.
+		 */
+		size_t findNearestPoint(const NJS_VECTOR& position) const;
+
+	private:
+		const LoopHead* spline;
+		// The distance along the spline of each point, starting at 0.
+		std::vector<float> pointDistances;
+		// Point indices ordered as an implicit k-d tree. The middle of each
+		// range splits it on the x, y or z axis, in turn by depth.
+		std::vector<uint32_t> pointTree;
+		void buildTree(size_t begin, size_t end, int axis);
+		void findNearestPoint(
+			size_t begin,
+			size_t end,
+			int axis,
+			const NJS_VECTOR& position,
+			size_t& nearestPoint,
+			float& nearestSquaredDistance
+		) const;
+};
@@ -0,0 +1,144 @@
+/**
+ * SplineTessellator.cpp
+ *
+ * Description:
+ *    Builds dense rail splines from a few control points, so spline files
+ *    only need to list the points a rail bends around.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "SplineTessellator.h"
+#include <algorithm>
+#include <cmath>
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#define TESSELLATOR_USE_SSE
+#include <emmintrin.h>
+#endif
+// Keeps knot intervals of repeated control points from dividing by zero.
+#define MIN_KNOT_INTERVAL 1e-4
+
+/* A segment's cubic, evaluated as ((a * u + b) * u + c) * u + d. */
+struct SegmentCurve {
+	float a[3];
+	float b[3];
+	float c[3];
+	float d[3];
+};
+
+static double getKnotInterval(const NJS_VECTOR& from, const NJS_VECTOR& to) {
+	double dx = to.x - from.x;
+	double dy = to.y - from.y;
+	double dz = to.z - from.z;
+	// Centripetal parameterization: the square root of the chord length.
+	return std::max(std::pow(dx * dx + dy * dy + dz * dz, 0.25), MIN_KNOT_INTERVAL);
+}
+
+static double getAxis(const NJS_VECTOR& vector, int axis) {
+	return axis == 0 ? vector.x : axis == 1 ? vector.y : vector.z;
+}
+
+/*
+  Builds the curve from p1 to p2, with p0 and p3 around them, as a cubic
+  Hermite segment whose tangents come from the centripetal knot intervals.
+*/
+static SegmentCurve buildSegmentCurve(
+		const NJS_VECTOR& p0,
+		const NJS_VECTOR& p1,
+		const NJS_VECTOR& p2,
+		const NJS_VECTOR& p3) {
+	double t01 = getKnotInterval(p0, p1);
+	double t12 = getKnotInterval(p1, p2);
+	double t23 = getKnotInterval(p2, p3);
+	SegmentCurve curve;
+	for (int axis = 0; axis < 3; axis++) {
+		double v0 = getAxis(p0, axis);
+		double v1 = getAxis(p1, axis);
+		double v2 = getAxis(p2, axis);
+		double v3 = getAxis(p3, axis);
+		double m1 = v2 - v1 + t12 * ((v1 - v0) / t01 - (v2 - v0) / (t01 + t12));
+		double m2 = v2 - v1 + t12 * ((v3 - v2) / t23 - (v3 - v1) / (t12 + t23));
+		curve.a[axis] = (float)(2 * v1 - 2 * v2 + m1 + m2);
+		curve.b[axis] = (float)(-3 * v1 + 3 * v2 - 2 * m1 - m2);
+		curve.c[axis] = (float)m1;
+		curve.d[axis] = (float)v1;
+	}
+	return curve;
+}
+
+/* Writes the curve's positions at u = 0, 1 / density, and so on. */
+static void evaluateSegment(const SegmentCurve& curve, int density, LoopPoint* points) {
+	float step = 1.0f / density;
+	int i = 0;
+#ifdef TESSELLATOR_USE_SSE
+	const __m128 offsets = _mm_set_ps(3, 2, 1, 0);
+	for (; i + 4 <= density; i += 4) {
+		__m128 u = _mm_mul_ps(_mm_add_ps(_mm_set1_ps((float)i), offsets), _mm_set1_ps(step));
+		float values[3][4];
+		for (int axis = 0; axis < 3; axis++) {
+			__m128 value = _mm_set1_ps(curve.a[axis]);
+			value = _mm_add_ps(_mm_mul_ps(value, u), _mm_set1_ps(curve.b[axis]));
+			value = _mm_add_ps(_mm_mul_ps(value, u), _mm_set1_ps(curve.c[axis]));
+			value = _mm_add_ps(_mm_mul_ps(value, u), _mm_set1_ps(curve.d[axis]));
+			_mm_storeu_ps(values[axis], value);
+		}
+		for (int lane = 0; lane < 4; lane++) {
+			points[i + lane].Position = { values[0][lane], values[1][lane], values[2][lane] };
+		}
+	}
+#endif
+	for (; i < density; i++) {
+		float u = (float)i * step;
+		float values[3];
+		for (int axis = 0; axis < 3; axis++) {
+			values[axis] = ((curve.a[axis] * u + curve.b[axis]) * u + curve.c[axis]) * u + curve.d[axis];
+		}
+		points[i].Position = { values[0], values[1], values[2] };
+	}
+}
+
+uint64_t getTessellatedPointCount(size_t controlPointCount, int density) {
+	return (uint64_t)(controlPointCount - 1) * (uint64_t)density + 1;
+}
+
+void tessellateSpline(
+		const LoopPoint* controlPoints,
+		size_t controlPointCount,
+		int density,
+		LoopPoint* points) {
+	auto getPosition = [controlPoints](size_t index) {
+		return controlPoints[index].Position;
+	};
+	// The ends are continued in a straight line past the first and last
+	// control points.
+	auto extend = [](const NJS_VECTOR& end, const NJS_VECTOR& next) {
+		return NJS_VECTOR{ 2 * end.x - next.x, 2 * end.y - next.y, 2 * end.z - next.z };
+	};
+	size_t last = controlPointCount - 1;
+	for (size_t i = 0; i < last; i++) {
+		NJS_VECTOR p0 = i > 0 ? getPosition(i - 1) : extend(getPosition(0), getPosition(1));
+		NJS_VECTOR p3 = i + 2 <= last ? getPosition(i + 2) : extend(getPosition(last), getPosition(last - 1));
+		SegmentCurve curve = buildSegmentCurve(p0, getPosition(i), getPosition(i + 1), p3);
+		evaluateSegment(curve, density, points + i * density);
+	}
+	points[last * density].Position = getPosition(last);
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,31 @@
+#pragma once
+#include "pch.h"
+#include <cstdint>
+
+/**
+ * Returns how many points tessellating a spline with the given number of
+ * control points makes, with density points per control point segment.
+ * Counted in 64 bits, as huge densities overflow a 32 bit size_t.
+ */
+uint64_t getTessellatedPointCount(size_t controlPointCount, int density);
+
+/**
+ * Fills points with a centripetal Catmull-Rom curve through the positions of
+ * the control points. The centripetal form keeps segments free of cusps and
+ * self-intersections, but the curve can still swing a little past a sharp
+ * turn: through (0,0,0), (10,0,0) and (10,0,10), it swings out about 0.7
+ * units on each side of the corner. Add control points around sharp turns
+ * to keep a rail tight. Each segment between two control points gets
+ * density points, evaluated 4 at a time with SSE where available, and the
+ * last control point ends the curve. Only positions are written, see
+ * recomputeSplineMetrics for the rest.
+ *
+ * @param [controlPoints] - At least 2 points to pass through.
+ * @param [points] - Room for getTessellatedPointCount points.
+ */
+void tessellateSpline(
+	const LoopPoint* controlPoints,
+	size_t controlPointCount,
+	int density,
+	LoopPoint* points
+);
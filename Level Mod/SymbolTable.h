@@ -0,0 +1,14 @@
+#pragma once
+#include "pch.h"
+#include <string>
+
+/**
+ * Looks up exported symbols by name. The game's data DLL is the real symbol
+ * table; tests and tools can stand in their own.
+ */
+class SymbolTable {
+	public:
+		virtual ~SymbolTable() = default;
+		/* Returns the address of the named symbol, or nullptr. */
+		virtual void* findSymbol(const std::string& name) const = 0;
+};
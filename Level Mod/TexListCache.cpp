@@ -0,0 +1,121 @@
+/**
+ * TexListCache.cpp
+ *
+ * Description:
+ *    Creates the texlists of imported levels from the contents of their
+ *    texture packs, and shares them between levels using the same pack.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "TexListCache.h"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+// Used when a texture pack's file table can't be read.
+#define DEFAULT_NUMBER_OF_TEXTURES 256
+// The game supports up to 500 textures per level.
+#define MAX_NUMBER_OF_TEXTURES 500
+// Texture packs start with "\x01pak", their file table starts at 0x39.
+#define PAK_MAGIC 0x6B617001
+#define PAK_FILE_TABLE_OFFSET 0x39
+
+std::shared_ptr<SharedTexList> TexListCache::get(const AssetIndex& assetIndex, const std::string& pakFileName, bool showWarnings) {
+	std::string textureName = removeFileExtension(pakFileName);
+	std::string key = textureName;
+	std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+	std::lock_guard<std::mutex> lock(mutex);
+	std::shared_ptr<SharedTexList> sharedTexList = texLists[key].lock();
+	if (sharedTexList != nullptr) {
+		return sharedTexList;
+	}
+	int textureCount = -1;
+	const AssetEntry* pakFile =
+		assetIndex.find(AssetFolder::PRS, textureName + ".pak");
+	if (pakFile != nullptr) {
+		textureCount = readPakTextureCount(pakFile->path);
+	}
+	if (textureCount < 0) {
+		printDebug("(Warning) Could not read the textures in \"" +
+			textureName + ".pak\", using " +
+			std::to_string(DEFAULT_NUMBER_OF_TEXTURES) + " texture slots.");
+		textureCount = DEFAULT_NUMBER_OF_TEXTURES;
+	}
+	if (textureCount > MAX_NUMBER_OF_TEXTURES) {
+		showWarning("Warning: \"" + textureName + ".pak\" has " +
+			std::to_string(textureCount) + " textures, but levels can only "
+			"use " + std::to_string(MAX_NUMBER_OF_TEXTURES) + ".", showWarnings);
+		textureCount = MAX_NUMBER_OF_TEXTURES;
+	}
+	sharedTexList = std::make_shared<SharedTexList>();
+	sharedTexList->textureNames =
+		std::make_unique<NJS_TEXNAME[]>(std::max(textureCount, 1));
+	sharedTexList->texList.textures = sharedTexList->textureNames.get();
+	sharedTexList->texList.nbTexture = textureCount;
+	sharedTexList->textureName = textureName;
+	texLists[key] = sharedTexList;
+	return sharedTexList;
+}
+
+int TexListCache::readPakTextureCount(const std::filesystem::path& pakPath) {
+	std::ifstream pakFile(pakPath, std::ios::binary);
+	auto readInt = [&pakFile]() -> int32_t {
+		int32_t value = -1;
+		pakFile.read((char*)&value, sizeof(value));
+		return pakFile ? value : -1;
+	};
+	if ((uint32_t)readInt() != PAK_MAGIC) {
+		return -1;
+	}
+	pakFile.seekg(PAK_FILE_TABLE_OFFSET);
+	int32_t fileCount = readInt();
+	if (fileCount < 0) {
+		return -1;
+	}
+	// Each file table entry is a long path, a name, and two lengths. Every
+	// file but the .inf index is a texture.
+	int textureCount = 0;
+	std::string name;
+	for (int32_t i = 0; i < fileCount; i++) {
+		int32_t longPathLength = readInt();
+		if (longPathLength < 0) {
+			return -1;
+		}
+		pakFile.seekg(longPathLength, std::ios::cur);
+		int32_t nameLength = readInt();
+		if (nameLength < 0 || nameLength > 1024) {
+			return -1;
+		}
+		name.resize(nameLength);
+		pakFile.read(name.data(), nameLength);
+		readInt();
+		readInt();
+		if (!pakFile) {
+			return -1;
+		}
+		std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+		if (name.size() < 4 || name.compare(name.size() - 4, 4, ".inf") != 0) {
+			textureCount++;
+		}
+	}
+	return textureCount;
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
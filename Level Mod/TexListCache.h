@@ -0,0 +1,50 @@
+#pragma once
+#include "pch.h"
+#include "AssetIndex.h"
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/* A texlist shared by every imported level that uses the same texture pack. */
+struct SharedTexList {
+	NJS_TEXLIST texList{};
+	std::unique_ptr<NJS_TEXNAME[]> textureNames;
+	// The texture pack's name without an extension, for LandTable.TextureName.
+	std::string textureName;
+};
+
+/**
+ * Creates texlists sized to the number of textures in their texture pack,
+ * and shares them between levels. A texlist is freed once no loaded level
+ * uses it anymore. Safe to use from the preloader's threads.
+ */
+class TexListCache {
+	public:
+		/**
+		 * Returns the texlist for a texture pack in the mod's PRS folder,
+		 * creating it if no loaded level uses that pack yet.
+		 *
+		 * @param [assetIndex] - The index used to find the texture pack.
+		 * @param [pakFileName] - The texture pack's name, with or without
+		 *     the .pak extension.
+		 * @param [showWarnings] - Whether to show a dialog for a texture
+		 *     pack with too many textures, rather than only logging it.
+		 */
+		std::shared_ptr<SharedTexList> get(
+			const AssetIndex& assetIndex,
+			const std::string& pakFileName,
+			bool showWarnings
+		);
+
+		/**
+		 * Reads the number of textures in a texture pack from its file table.
+		 * Returns -1 if the file is missing or is not a texture pack.
+		 */
+		static int readPakTextureCount(const std::filesystem::path& pakPath);
+
+	private:
+		std::mutex mutex;
+		std::unordered_map<std::string, std::weak_ptr<SharedTexList>> texLists;
+};
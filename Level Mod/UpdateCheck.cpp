@@ -0,0 +1,312 @@
+/**
+ * UpdateCheck.cpp
+ *
+ * Description:
+ *    Checks for a newer version of My Level Mod in the background, reusing
+ *    the last result for a day so most launches stay off the network.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "UpdateCheck.h"
+#include <algorithm>
+#include <charconv>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+// Current version of My Level Mod.
+#define VERSION 4.6f
+// How long the update check may take, in seconds, before it is abandoned.
+#define UPDATE_CONNECT_TIMEOUT 5L
+#define UPDATE_TOTAL_TIMEOUT 10L
+// How long, in seconds, a saved update check result is trusted before the
+// version file is requested again.
+#define UPDATE_CACHE_TTL (24 * 60 * 60)
+#define UPDATE_CACHE_FILE "update_check.ini"
+
+// The background update check started by startUpdateCheck().
+static std::thread updateThread;
+static std::atomic<bool> updateCancelled{ false };
+
+void startUpdateCheck(const char* modFolderPath, std::string updateURL) {
+	if (updateThread.joinable()) {
+		return;
+	}
+	// curl_global_init is not thread safe, so it must run before the
+	// background thread starts.
+	curl_global_init(CURL_GLOBAL_ALL);
+	updateCancelled = false;
+	updateThread = std::thread(
+		[](std::string modFolderPath, std::string updateURL) {
+			// An exception escaping a thread would close the game.
+			try {
+				checkForUpdate(modFolderPath, updateURL);
+			} catch (...) {
+				printDebug("(Warning) Update check failed unexpectedly.");
+			}
+		},
+		std::string(modFolderPath),
+		std::move(updateURL)
+	);
+}
+
+void stopUpdateCheck() {
+	if (!updateThread.joinable()) {
+		return;
+	}
+	// The transfer callback aborts curl within a second of this being set.
+	updateCancelled = true;
+	updateThread.join();
+	curl_global_cleanup();
+}
+
+bool fetchLatestVersion(const std::string& updateURL, bool hasCache,
+		UpdateCache& cache, const std::atomic<bool>& cancelled) {
+	std::string result;
+	CURL* curl = curl_easy_init();
+	if (!curl) {
+		printDebug("(Warning) Could not check for update. "
+			"[Curl will not instantiate]");
+		return false;
+	}
+	// Disable cached HTML requests.
+	struct curl_slist* headers = NULL;
+	headers = curl_slist_append(headers, "Cache-control: no-cache");
+	// Let the server answer 304 Not Modified if nothing changed.
+	if (hasCache && !cache.eTag.empty()) {
+		headers = curl_slist_append(headers,
+			("If-None-Match: " + cache.eTag).c_str());
+	}
+	if (hasCache && !cache.lastModified.empty()) {
+		headers = curl_slist_append(headers,
+			("If-Modified-Since: " + cache.lastModified).c_str());
+	}
+	UpdateCache response;
+
+	// Read version number from github, store result as string.
+	curl_easy_setopt(curl, CURLOPT_URL, updateURL.c_str());
+	curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writer);
+	curl_easy_setopt(curl, CURLOPT_WRITEDATA, &result);
+	curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, headerWriter);
+	curl_easy_setopt(curl, CURLOPT_HEADERDATA, &response);
+	// Never let a slow or unreachable server hold on to the thread, and allow
+	// OnExit to abort the transfer.
+	curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+	curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, UPDATE_CONNECT_TIMEOUT);
+	curl_easy_setopt(curl, CURLOPT_TIMEOUT, UPDATE_TOTAL_TIMEOUT);
+	curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+	curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, cancelCheck);
+	curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &cancelled);
+	CURLcode curlResult = curl_easy_perform(curl);
+	long responseCode = 0;
+	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &responseCode);
+	curl_slist_free_all(headers);
+	curl_easy_cleanup(curl);
+	if (curlResult != CURLE_OK) {
+		printDebug("(Warning) Could not check for update. [" +
+			std::string(curl_easy_strerror(curlResult)) + "]");
+		return false;
+	}
+	if (responseCode == 304 && hasCache) {
+		printDebug("Version file not modified since the last check.");
+		if (!response.eTag.empty()) {
+			cache.eTag = response.eTag;
+		}
+		if (!response.lastModified.empty()) {
+			cache.lastModified = response.lastModified;
+		}
+		return true;
+	}
+	if (responseCode != 200) {
+		printDebug("(Warning) Could not check for update. [HTTP " +
+			std::to_string(responseCode) + "]");
+		return false;
+	}
+	if (!parseVersion(result, cache.latestVersion)) {
+		printDebug("(Warning) Could not check for update. [Invalid version "
+			"\"" + result + "\"]");
+		return false;
+	}
+	cache.eTag = response.eTag;
+	cache.lastModified = response.lastModified;
+	return true;
+}
+
+bool parseVersion(std::string_view text, float& version) {
+	auto isSpace = [](char c) {
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+	};
+	while (!text.empty() && isSpace(text.front())) {
+		text.remove_prefix(1);
+	}
+	while (!text.empty() && isSpace(text.back())) {
+		text.remove_suffix(1);
+	}
+	float parsed = 0;
+	const char* end = text.data() + text.size();
+	auto [ptr, error] = std::from_chars(text.data(), end, parsed,
+		std::chars_format::fixed);
+	if (text.empty() || error != std::errc() || ptr != end || !(parsed > 0)) {
+		return false;
+	}
+	version = parsed;
+	return true;
+}
+
+bool readUpdateCache(const std::string& cachePath, UpdateCache& cache) {
+	std::ifstream cacheFile(cachePath);
+	if (!cacheFile.is_open()) {
+		return false;
+	}
+	bool hasVersion = false, hasTime = false;
+	std::string line;
+	while (std::getline(cacheFile, line)) {
+		size_t equals = line.find('=');
+		if (equals == std::string::npos) {
+			continue;
+		}
+		std::string key = line.substr(0, equals);
+		std::string value = line.substr(equals + 1);
+		if (key == "latest_version") {
+			hasVersion = parseVersion(value, cache.latestVersion);
+		} else if (key == "checked_at") {
+			auto [ptr, error] = std::from_chars(value.data(),
+				value.data() + value.size(), cache.checkedAt);
+			hasTime = error == std::errc() &&
+				ptr == value.data() + value.size();
+		} else if (key == "etag") {
+			cache.eTag = value;
+		} else if (key == "last_modified") {
+			cache.lastModified = value;
+		}
+	}
+	return hasVersion && hasTime;
+}
+
+void writeUpdateCache(const std::string& cachePath, const UpdateCache& cache) {
+	std::ofstream cacheFile(cachePath, std::ofstream::out | std::ofstream::trunc);
+	if (!cacheFile.is_open()) {
+		printDebug("(Warning) Could not save the update check result.");
+		return;
+	}
+	cacheFile << "latest_version=" << std::to_string(cache.latestVersion) <<
+		std::endl;
+	cacheFile << "checked_at=" << cache.checkedAt << std::endl;
+	cacheFile << "etag=" << cache.eTag << std::endl;
+	cacheFile << "last_modified=" << cache.lastModified << std::endl;
+}
+
+void checkForUpdate(std::string modFolderPath, std::string updateURL) {
+	printDebug("Checking for updates...");
+	std::string cachePath = modFolderPath + "\\" + UPDATE_CACHE_FILE;
+	UpdateCache cache;
+	bool hasCache = readUpdateCache(cachePath, cache);
+	long long now = (long long)std::time(nullptr);
+	if (hasCache && now >= cache.checkedAt
+			&& now - cache.checkedAt < UPDATE_CACHE_TTL) {
+		printDebug("Using cached update check.");
+	} else {
+		if (!fetchLatestVersion(updateURL, hasCache, cache, updateCancelled)) {
+			return;
+		}
+		cache.checkedAt = now;
+		writeUpdateCache(cachePath, cache);
+	}
+	float latestVersion = cache.latestVersion;
+
+	// Save a notification file if an update is detected.
+	if (VERSION < latestVersion) {
+		printDebug("Update detected! Creating update reminder.");
+		std::string updatePath = modFolderPath + "\\Mod "
+			"developers: manually UPDATE to VERSION " + 
+			std::to_string(latestVersion) + ".txt";
+		if (!std::filesystem::exists(updatePath)) {
+			std::ofstream updateFile;
+			updateFile.open(updatePath, std::ofstream::out);
+			updateFile << "An update has been detected for My Level Mod!" <<
+				std::endl;
+			updateFile << "Please download and update your mod manually. "
+				"Download link:" << std::endl;
+			updateFile << "https://github.com/J-N-R/My-Level-Mod/"
+				"releases" << std::endl;
+			updateFile.close();
+		}
+	}
+	// Delete existing notification files if My Level Mod is up to date.
+	else {
+		printDebug("Mod up to date.");
+		bool cleaned = false;
+		for (const auto& file : std::filesystem::directory_iterator(modFolderPath)) {
+			std::string filePath = file.path().string();
+			if (filePath.find("UPDATE") != std::string::npos) {
+				std::filesystem::remove(filePath);
+				cleaned = true;
+			}
+		}
+		if (cleaned) {
+			printDebug("Cleaned up update reminders.");
+		}
+	}
+}
+
+int writer(char* data, size_t size,
+	size_t nmemb, std::string* buffer) {
+	int result = 0;
+	if (buffer != NULL) {
+		buffer->append(data, size * nmemb);
+		result = size * nmemb;
+	}
+	return result;
+}
+
+size_t headerWriter(char* data, size_t size, size_t nmemb,
+		UpdateCache* response) {
+	size_t length = size * nmemb;
+	std::string header(data, length);
+	size_t colon = header.find(':');
+	if (response == NULL || colon == std::string::npos) {
+		return length;
+	}
+	std::string name = header.substr(0, colon);
+	std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+	// Trim the leading space and trailing CRLF around the header's value.
+	size_t valueStart = header.find_first_not_of(" \t", colon + 1);
+	size_t valueEnd = header.find_last_not_of(" \t\r\n");
+	std::string value = valueStart == std::string::npos || valueEnd < valueStart
+		? std::string()
+		: header.substr(valueStart, valueEnd - valueStart + 1);
+	if (name == "etag") {
+		response->eTag = value;
+	} else if (name == "last-modified") {
+		response->lastModified = value;
+	}
+	return length;
+}
+
+int cancelCheck(void* data, curl_off_t downloadTotal, curl_off_t downloaded,
+		curl_off_t uploadTotal, curl_off_t uploaded) {
+	// Any non-zero value aborts the transfer.
+	return *(const std::atomic<bool>*)data ? 1 : 0;
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
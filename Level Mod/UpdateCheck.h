@@ -0,0 +1,74 @@
+#pragma once
+#include "pch.h"
+#include <atomic>
+#include <curl/curl.h>
+#include <string>
+#include <string_view>
+#define UPDATE_URL "https://raw.githubusercontent.com/J-N-R/My-Level-Mod/master/VERSION.txt"
+
+/* The result of the last update check, saved in the mod folder. */
+struct UpdateCache {
+	float latestVersion = 0;
+	// Seconds since the epoch when the version file was last requested.
+	long long checkedAt = 0;
+	// Validators returned by the server, sent back on the next request.
+	std::string eTag;
+	std::string lastModified;
+};
+
+/*
+  Checks the internet for an update to My Level Mod and saves a 
+  notification file in the mod folder if an update is detected. The network
+  is only used once the saved result is a day old. Blocks until the check
+  finishes or times out, use startUpdateCheck() during Init.
+*/
+void checkForUpdate(std::string modFolderPath, std::string updateURL);
+
+/*
+  Runs checkForUpdate() on a background thread so the game never waits on the
+  network. The update URL can be pointed at a local server for testing.
+*/
+void startUpdateCheck(
+	const char* modFolderPath,
+	std::string updateURL = UPDATE_URL
+);
+
+/*
+  Cancels a running update check and waits for its thread to finish. A no-op
+  if no update check was started.
+*/
+void stopUpdateCheck();
+
+/*
+  Requests the version file, sending the cached validators so the server can
+  answer 304 Not Modified. Updates the cache and returns true on success.
+  The transfer is abandoned soon after cancelled is set.
+*/
+bool fetchLatestVersion(const std::string& updateURL, bool hasCache,
+	UpdateCache& cache, const std::atomic<bool>& cancelled);
+
+/*
+  Strictly parses a version number such as "4.6". Surrounding whitespace is
+  allowed, anything else fails without throwing.
+*/
+bool parseVersion(std::string_view text, float& version);
+
+/* Reads a saved update check result. Returns false if there is none. */
+bool readUpdateCache(const std::string& cachePath, UpdateCache& cache);
+
+/* Saves an update check result to be reused by the next launch. */
+void writeUpdateCache(const std::string& cachePath, const UpdateCache& cache);
+
+/** Helper function for checkForUpdate(). */
+int writer(char* data, size_t size, size_t nmemb, std::string* buffer);
+
+/** Helper function for checkForUpdate(), saves the ETag and Last-Modified. */
+size_t headerWriter(char* data, size_t size, size_t nmemb,
+	UpdateCache* response);
+
+/**
+ * Helper function for checkForUpdate(), aborts the transfer once the
+ * std::atomic<bool> given as data is set.
+ */
+int cancelCheck(void* data, curl_off_t downloadTotal, curl_off_t downloaded,
+	curl_off_t uploadTotal, curl_off_t uploaded);
@@ -0,0 +1,170 @@
+/**
+ * ValueParser.cpp
+ *
+ * Description:
+ *    Parses numbers and positions out of ini values with std::from_chars.
+ *    Bad input is reported through the returned ParseResult instead of an
+ *    exception, so callers can name the key and text in their warning.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "ValueParser.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+
+#define NOT_A_NUMBER "is not a number"
+#define OUT_OF_RANGE "is out of range"
+#define TRAILING_TEXT "has extra text after the number"
+#define NOT_FINITE "is not a finite number"
+#define NOT_A_POSITION "is not three comma separated numbers"
+#define NOT_A_BOOLEAN "is not true or false"
+
+template <typename T, typename... Base>
+static ParseResult<T> parseNumber(std::string_view text, Base... base) {
+	ParseResult<T> result;
+	const char* end = text.data() + text.size();
+	auto [parsedEnd, error] = std::from_chars(text.data(), end, result.value, base...);
+	if (error == std::errc::invalid_argument) {
+		result.error = NOT_A_NUMBER;
+	} else if (error == std::errc::result_out_of_range) {
+		result.error = OUT_OF_RANGE;
+	} else if (parsedEnd != end) {
+		result.error = TRAILING_TEXT;
+	}
+	return result;
+}
+
+static std::string_view trim(std::string_view text) {
+	const char* whitespace = " \t\r";
+	size_t start = text.find_first_not_of(whitespace);
+	if (start == std::string_view::npos) {
+		return std::string_view();
+	}
+	size_t end = text.find_last_not_of(whitespace);
+	return text.substr(start, end - start + 1);
+}
+
+ParseResult<int> parseInt(std::string_view text) {
+	text = trim(text);
+	if (!text.empty() && text.front() == '+') {
+		text.remove_prefix(1);
+	}
+	return parseNumber<int>(text, 10);
+}
+
+ParseResult<float> parseFloat(std::string_view text) {
+	text = trim(text);
+	// from_chars does not accept a leading '+'.
+	if (!text.empty() && text.front() == '+') {
+		text.remove_prefix(1);
+	}
+	// from_chars also reads nan and inf, which no option or spline can use.
+	ParseResult<float> result = parseNumber<float>(text);
+	if (result && !std::isfinite(result.value)) {
+		return ParseResult<float>{ 0, NOT_FINITE };
+	}
+	return result;
+}
+
+ParseResult<uint32_t> parseHex(std::string_view text) {
+	text = trim(text);
+	if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+		text.remove_prefix(2);
+	}
+	return parseNumber<uint32_t>(text, 16);
+}
+
+ParseResult<NJS_VECTOR> parsePosition(std::string_view text) {
+	ParseResult<NJS_VECTOR> result;
+	float* coords[3] = { &result.value.x, &result.value.y, &result.value.z };
+	for (int i = 0; i < 3; i++) {
+		size_t comma = text.find(',');
+		if ((i < 2) == (comma == std::string_view::npos)) {
+			result.error = NOT_A_POSITION;
+			return result;
+		}
+		ParseResult<float> coord = parseFloat(text.substr(0, comma));
+		if (!coord) {
+			result.error = coord.error;
+			return result;
+		}
+		*coords[i] = coord.value;
+		text.remove_prefix(i < 2 ? comma + 1 : text.size());
+	}
+	return result;
+}
+
+/* Compares text to an uppercase word, ignoring the text's case. */
+static bool equalsWord(std::string_view text, std::string_view word) {
+	return text.size() == word.size() && std::equal(text.begin(), text.end(),
+		word.begin(), [](char a, char b) { return toupper(a) == b; });
+}
+
+ParseResult<float> parseDeathPlane(std::string_view text) {
+	ParseResult<float> result = parseFloat(text);
+	if (result) {
+		return result;
+	}
+	text = trim(text);
+	for (std::string_view disabled : { "OFF", "FALSE" }) {
+		if (equalsWord(text, disabled)) {
+			return ParseResult<float>{ DISABLED_PLANE, nullptr };
+		}
+	}
+	return result;
+}
+
+ParseResult<bool> parseBool(std::string_view text) {
+	text = trim(text);
+	for (std::string_view word : { "TRUE", "ON", "YES", "1" }) {
+		if (equalsWord(text, word)) {
+			return ParseResult<bool>{ true, nullptr };
+		}
+	}
+	for (std::string_view word : { "FALSE", "OFF", "NO", "0" }) {
+		if (equalsWord(text, word)) {
+			return ParseResult<bool>{ false, nullptr };
+		}
+	}
+	return ParseResult<bool>{ false, NOT_A_BOOLEAN };
+}
+
+std::vector<std::string> splitList(std::string_view text) {
+	std::vector<std::string> items;
+	while (!text.empty()) {
+		size_t comma = std::min(text.find(','), text.size());
+		std::string_view item = trim(text.substr(0, comma));
+		if (!item.empty()) {
+			items.emplace_back(item);
+		}
+		text.remove_prefix(std::min(comma + 1, text.size()));
+	}
+	return items;
+}
+
+std::string describeParseError(std::string_view key, std::string_view text, const char* error) {
+	return "Invalid " + std::string(key) + " given: \"" + std::string(text) +
+		"\" (" + error + ").";
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
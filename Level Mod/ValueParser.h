@@ -0,0 +1,43 @@
+#pragma once
+#include "pch.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * The result of parsing an ini value: either the value, or a short reason
+ * the text could not be parsed. Parsing never throws or allocates.
+ */
+template <typename T>
+struct ParseResult {
+	T value{};
+	// nullptr if the value was parsed.
+	const char* error = nullptr;
+
+	explicit operator bool() const {
+		return error == nullptr;
+	}
+};
+
+/* Parses a whole value as a decimal integer. A leading '+' is allowed. */
+ParseResult<int> parseInt(std::string_view text);
+/* Parses a whole value as a finite float. A leading '+' is allowed. */
+ParseResult<float> parseFloat(std::string_view text);
+/* Parses a whole value as hex, with or without a 0x prefix. */
+ParseResult<uint32_t> parseHex(std::string_view text);
+/* Parses an "x, y, z" position. */
+ParseResult<NJS_VECTOR> parsePosition(std::string_view text);
+/* Parses a number, or OFF or FALSE in any case as DISABLED_PLANE. */
+ParseResult<float> parseDeathPlane(std::string_view text);
+/* Parses TRUE, ON, YES or 1, or FALSE, OFF, NO or 0, in any case. */
+ParseResult<bool> parseBool(std::string_view text);
+/* Splits a comma separated list, dropping spaces around and empty items. */
+std::vector<std::string> splitList(std::string_view text);
+
+/* Builds a message like: Invalid key given: "text" (is not a number). */
+std::string describeParseError(
+	std::string_view key,
+	std::string_view text,
+	const char* error
+);
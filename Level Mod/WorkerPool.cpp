@@ -0,0 +1,128 @@
+/**
+ * WorkerPool.cpp
+ *
+ * Description:
+ *    A shared pool of worker threads that splits a task into jobs. See
+ *    WorkerPool.h.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "WorkerPool.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool(size_t threadCount) {
+	for (size_t i = 0; i < threadCount; i++) {
+		threads.emplace_back([this]() { runWorker(); });
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	workReady.notify_all();
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+}
+
+void WorkerPool::run(size_t count, const Job& job) {
+	if (count == 0) {
+		return;
+	}
+	// A single job isn't worth waking a thread for.
+	if (count == 1 || threads.empty()) {
+		for (size_t i = 0; i < count; i++) {
+			job(i);
+		}
+		return;
+	}
+	Batch batch;
+	batch.job = &job;
+	batch.count = count;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		batches.push_back(&batch);
+	}
+	workReady.notify_all();
+	size_t finishedJobs = work(batch);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	batches.erase(std::remove(batches.begin(), batches.end(), &batch), batches.end());
+	batch.finishedJobs += finishedJobs;
+	// Workers still holding the batch must let go of it before it goes out
+	// of scope.
+	batchFinished.wait(lock, [&batch]() {
+		return batch.finishedJobs == batch.count && batch.activeWorkers == 0;
+	});
+	if (batch.exception != nullptr) {
+		std::rethrow_exception(batch.exception);
+	}
+}
+
+size_t WorkerPool::getThreadCount() const {
+	return threads.size();
+}
+
+void WorkerPool::runWorker() {
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		workReady.wait(lock, [this]() { return stopping || !batches.empty(); });
+		if (stopping) {
+			return;
+		}
+		Batch* batch = batches.front();
+		batch->activeWorkers++;
+		lock.unlock();
+		size_t finishedJobs = work(*batch);
+		lock.lock();
+		// No jobs are left to start, so other workers can skip the batch.
+		batches.erase(std::remove(batches.begin(), batches.end(), batch), batches.end());
+		batch->finishedJobs += finishedJobs;
+		batch->activeWorkers--;
+		if (batch->finishedJobs == batch->count && batch->activeWorkers == 0) {
+			batchFinished.notify_all();
+		}
+	}
+}
+
+size_t WorkerPool::work(Batch& batch) {
+	size_t finishedJobs = 0;
+	for (size_t i = batch.nextJob++; i < batch.count; i = batch.nextJob++) {
+		// Skipped jobs still count as finished, so the batch can drain.
+		if (!batch.failed) {
+			try {
+				(*batch.job)(i);
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(mutex);
+				if (batch.exception == nullptr) {
+					batch.exception = std::current_exception();
+				}
+				batch.failed = true;
+			}
+		}
+		finishedJobs++;
+	}
+	return finishedJobs;
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,64 @@
+#pragma once
+#include "pch.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A small pool of threads for splitting one task, such as reading a level's
+ * spline files, into jobs that run at the same time. The thread calling run
+ * works on its own jobs too, so a pool can be shared by callers that are
+ * themselves worker threads without ever waiting on a busy pool.
+ */
+class WorkerPool {
+	public:
+		using Job = std::function<void(size_t index)>;
+
+		WorkerPool(size_t threadCount);
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+		~WorkerPool();
+
+		/**
+		 * Runs job(0) to job(count - 1) across the pool and the calling
+		 * thread, and returns once all of them are done. Jobs may finish in
+		 * any order. If a job throws, the jobs that haven't started are
+		 * skipped, and the first exception is rethrown here once every
+		 * running job is done.
+		 */
+		void run(size_t count, const Job& job);
+
+		/** The number of pool threads, not counting callers. */
+		size_t getThreadCount() const;
+
+	private:
+		struct Batch {
+			const Job* job;
+			size_t count;
+			std::atomic<size_t> nextJob{ 0 };
+			std::atomic<bool> failed{ false };
+			// Guarded by the pool's mutex.
+			size_t finishedJobs = 0;
+			size_t activeWorkers = 0;
+			std::exception_ptr exception;
+		};
+		std::vector<std::thread> threads;
+		std::mutex mutex;
+		std::condition_variable workReady;
+		std::condition_variable batchFinished;
+		// Batches that may still have jobs left to start.
+		std::deque<Batch*> batches;
+		bool stopping = false;
+		void runWorker();
+		/*
+		  Runs a batch's jobs until none are left to start, and returns how
+		  many it ran. Never throws, the first exception is kept in the
+		  batch.
+		*/
+		size_t work(Batch& batch);
+};
@@ -0,0 +1,154 @@
+/**
+ * AssetIndexTests.cpp
+ *
+ * Description:
+ *    Builds an AssetIndex over a synthetic mod folder with thousands of
+ *    files, checking its lookups against the files on disk and timing the
+ *    scan and the lookups a level load makes.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "AssetIndex.h"
+#include "TestSupport.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#define FILLER_COUNT 4000
+#define SPLINE_COUNT 500
+#define LOOKUP_COUNT 100000
+
+static void writeFile(const std::filesystem::path& path) {
+	std::ofstream file(path, std::ios::binary);
+	file << path.filename().string();
+}
+
+/* A mod folder with the files of one level, hidden among filler files. */
+static void makeModFolder(const std::filesystem::path& modPath) {
+	std::filesystem::path gdPCPath = modPath / "gd_PC";
+	std::filesystem::create_directories(gdPCPath / "PRS");
+	std::filesystem::create_directories(gdPCPath / "Paths");
+	writeFile(modPath / "level_options.ini");
+	writeFile(gdPCPath / "Forest.SA2BLVL");
+	writeFile(gdPCPath / "set0013_s.bin");
+	writeFile(gdPCPath / "SET0013_U.BIN");
+	// Not SET files, despite the prefix.
+	writeFile(gdPCPath / "set0013.bin");
+	writeFile(gdPCPath / "settings_s.bin");
+	writeFile(gdPCPath / "PRS" / "forest.pak");
+	for (int i = 0; i < FILLER_COUNT; i++) {
+		writeFile(gdPCPath / ("filler" + std::to_string(i) + ".dat"));
+	}
+	for (int i = 0; i < SPLINE_COUNT; i++) {
+		writeFile(gdPCPath / "Paths" / ("rail" + std::to_string(i) + ".ini"));
+	}
+}
+
+static void testLookups(const AssetIndex& assetIndex) {
+	const AssetEntry* levelFile = assetIndex.findFirst(AssetFolder::GdPC, "sa2blvl");
+	CHECK(levelFile != nullptr);
+	if (levelFile != nullptr) {
+		CHECK(levelFile->folder == AssetFolder::GdPC);
+		CHECK(levelFile->fileName == "forest.sa2blvl");
+		CHECK(levelFile->stem == "forest");
+		CHECK(levelFile->path.filename() == "Forest.SA2BLVL");
+		CHECK(levelFile->size == std::string("Forest.SA2BLVL").size());
+	}
+	// Extensions and names are compared without case, and by folder.
+	CHECK(assetIndex.findFirst(AssetFolder::GdPC, "SA2BLVL") == levelFile);
+	CHECK(assetIndex.find(AssetFolder::GdPC, "FOREST.sa2blvl") == levelFile);
+	CHECK(assetIndex.findFirst(AssetFolder::GdPC, "sa2lvl") == nullptr);
+	CHECK(assetIndex.findFirst(AssetFolder::GdPC, "pak") == nullptr);
+	CHECK(assetIndex.findFirst(AssetFolder::PRS, "pak") != nullptr);
+	CHECK(assetIndex.find(AssetFolder::ModRoot, "level_options.ini") != nullptr);
+	CHECK(assetIndex.find(AssetFolder::ModRoot, "forest.sa2blvl") == nullptr);
+	CHECK(assetIndex.findAll(AssetFolder::GdPC, "dat").size() == FILLER_COUNT);
+
+	std::vector<const AssetEntry*> splines = assetIndex.findAll(AssetFolder::Paths, "ini");
+	CHECK(splines.size() == SPLINE_COUNT);
+	CHECK(!splines.empty() && assetIndex.findFirst(AssetFolder::Paths, "ini") == splines.front());
+	bool allFound = true;
+	for (int i = 0; i < SPLINE_COUNT; i++) {
+		const AssetEntry* spline = assetIndex.find(AssetFolder::Paths,
+			"rail" + std::to_string(i) + ".ini");
+		allFound = allFound && spline != nullptr && spline->extension == "ini";
+	}
+	CHECK(allFound);
+
+	const AssetEntry* setFile = assetIndex.findSetFile(LevelIDs_GreenForest, 's');
+	CHECK(setFile != nullptr && setFile->fileName == "set0013_s.bin");
+	setFile = assetIndex.findSetFile(LevelIDs_GreenForest, 'U');
+	CHECK(setFile != nullptr && setFile->fileName == "set0013_u.bin");
+	CHECK(assetIndex.findSetFile(LevelIDs_ChaoWorld, 's') == nullptr);
+}
+
+static void testRefresh(AssetIndex& assetIndex, const std::filesystem::path& modPath) {
+	std::filesystem::path pakPath = modPath / "gd_PC" / "PRS" / "forest.pak";
+	std::filesystem::rename(pakPath, modPath / "gd_PC" / "forest.pak");
+	// Lookups keep seeing the scan until the index is refreshed.
+	CHECK(assetIndex.findFirst(AssetFolder::PRS, "pak") != nullptr);
+	CHECK(assetIndex.findFirst(AssetFolder::GdPC, "pak") == nullptr);
+	assetIndex.refresh();
+	CHECK(assetIndex.findFirst(AssetFolder::PRS, "pak") == nullptr);
+	CHECK(assetIndex.findFirst(AssetFolder::GdPC, "pak") != nullptr);
+	std::filesystem::rename(modPath / "gd_PC" / "forest.pak", pakPath);
+	assetIndex.refresh();
+	CHECK(assetIndex.findFirst(AssetFolder::PRS, "pak") != nullptr);
+}
+
+static void timeIndex(const std::filesystem::path& modPath) {
+	auto start = std::chrono::steady_clock::now();
+	AssetIndex assetIndex(modPath.string().c_str());
+	auto scanned = std::chrono::steady_clock::now();
+	size_t found = 0;
+	for (int i = 0; i < LOOKUP_COUNT; i++) {
+		found += assetIndex.findFirst(AssetFolder::GdPC, "sa2lvl") != nullptr;
+		found += assetIndex.findFirst(AssetFolder::GdPC, "sa2blvl") != nullptr;
+		found += assetIndex.findFirst(AssetFolder::PRS, "pak") != nullptr;
+	}
+	auto looked = std::chrono::steady_clock::now();
+	CHECK(found == 2 * LOOKUP_COUNT);
+	std::printf("Indexed %d files in %.2f ms, %d level file lookups in %.2f ms\n",
+		FILLER_COUNT + SPLINE_COUNT,
+		std::chrono::duration<double, std::milli>(scanned - start).count(),
+		3 * LOOKUP_COUNT,
+		std::chrono::duration<double, std::milli>(looked - scanned).count());
+}
+
+int main() {
+	std::filesystem::path modPath =
+		std::filesystem::temp_directory_path() / "AssetIndexTests";
+	std::filesystem::remove_all(modPath);
+	makeModFolder(modPath);
+	{
+		AssetIndex assetIndex(modPath.string().c_str());
+		testLookups(assetIndex);
+		testRefresh(assetIndex, modPath);
+	}
+	timeIndex(modPath);
+	std::filesystem::remove_all(modPath);
+	return finishTests("AssetIndexTests");
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,111 @@
+/**
+ * ImportRegistryTests.cpp
+ *
+ * Description:
+ *    Tests the import request registry: requests are found by level ID or
+ *    as chao garden requests, are moved in without copying their strings,
+ *    and looking them up on a level load makes no heap allocations.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "ImportRegistry.h"
+#include "TestSupport.h"
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#define LOAD_COUNT 1000
+
+// Requests can only be added by moving them in.
+static_assert(!std::is_invocable_v<
+	decltype(&ImportRegistry::add), ImportRegistry&, ImportRequest&>);
+static_assert(std::is_nothrow_move_constructible_v<ImportRequest>);
+
+/* A request with names too long to fit in a string's own buffer. */
+static ImportRequest makeRequest(LevelIDs levelID, const std::string& name) {
+	ImportRequest request;
+	request.levelID = levelID;
+	request.landTableName = "objLandTable_" + name + "_with_a_long_name";
+	request.levelFileName = name + "_level_file_with_a_long_name";
+	request.pakFileName = name + "_pak_file_with_a_long_name";
+	request.levelOptions.splineFileNames = { "rail1", "rail2" };
+	return request;
+}
+
+static void testLookups() {
+	ImportRegistry registry;
+	CHECK(registry.add(makeRequest(LevelIDs_GreenForest, "forest")) == 0);
+	CHECK(registry.add(makeRequest(LevelIDs_Invalid, "garden")) == 1);
+	CHECK(registry.add(makeRequest(LevelIDs_GreenForest, "forest2")) == 2);
+	CHECK(registry.size() == 3);
+
+	const std::vector<size_t>& forestRequests =
+		registry.findLevelRequests(LevelIDs_GreenForest);
+	CHECK(forestRequests == std::vector<size_t>({ 0, 2 }));
+	CHECK(registry.get(2).levelFileName == "forest2_level_file_with_a_long_name");
+	CHECK(registry.findLevelRequests(LevelIDs_ChaoWorld).empty());
+	CHECK(registry.getChaoGardenRequests() == std::vector<size_t>({ 1 }));
+	CHECK(registry.get(1).pakFileName == "garden_pak_file_with_a_long_name");
+
+	// Looking up the current level's requests, as every level load does.
+	size_t allocationCount = getAllocationCount();
+	size_t foundCount = 0;
+	for (int i = 0; i < LOAD_COUNT; i++) {
+		for (size_t index : registry.findLevelRequests(LevelIDs_GreenForest)) {
+			foundCount += registry.get(index).levelID == LevelIDs_GreenForest;
+		}
+		foundCount += registry.findLevelRequests(LevelIDs_ChaoWorld).size();
+		foundCount += registry.getChaoGardenRequests().size();
+	}
+	CHECK(getAllocationCount() == allocationCount);
+	CHECK(foundCount == 3 * LOAD_COUNT);
+}
+
+static void testMoves() {
+	ImportRegistry registry;
+	ImportRequest request = makeRequest(LevelIDs_GreenForest, "forest");
+	const char* landTableName = request.landTableName.data();
+	const char* levelFileName = request.levelFileName.data();
+	const std::string* splineFileNames = request.levelOptions.splineFileNames.data();
+	size_t index = registry.add(std::move(request));
+
+	// The registry holds the same buffers, so nothing was copied.
+	const ImportRequest& added = registry.get(index);
+	CHECK(added.landTableName.data() == landTableName);
+	CHECK(added.levelFileName.data() == levelFileName);
+	CHECK(added.levelOptions.splineFileNames.data() == splineFileNames);
+
+	// Requests never move once added, so loads can keep references to them.
+	for (int i = 0; i < LOAD_COUNT; i++) {
+		registry.add(makeRequest(LevelIDs_Invalid, "garden"));
+	}
+	CHECK(&registry.get(index) == &added);
+	CHECK(&registry.getRequests()[index] == &added);
+	CHECK(registry.getChaoGardenRequests().size() == LOAD_COUNT);
+}
+
+int main() {
+	testLookups();
+	testMoves();
+	return finishTests("ImportRegistryTests");
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
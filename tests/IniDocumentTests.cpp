@@ -0,0 +1,152 @@
+/**
+ * IniDocumentTests.cpp
+ *
+ * Description:
+ *    Checks that IniDocument reads comments, escapes, repeated keys and
+ *    repeated groups the way the mod loader's IniFile does, and prints its
+ *    throughput on a large synthetic spline file.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "IniDocument.h"
+#include "TestSupport.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#define SPLINE_POINTS 200000
+
+/* Returns a value of the document, or a marker saying what was missing. */
+static std::string_view getValue(const IniDocument& document,
+		std::string_view section, std::string_view key) {
+	const IniSection* found = document.findSection(section);
+	return found == nullptr ? "(no section)" : found->getValue(key, "(no key)");
+}
+
+static void testComments() {
+	std::string text =
+		"; a whole line comment\n"
+		"plain=value ; a comment\n"
+		"tight=a;b\n"
+		"long_key_past_sixteen_bytes=long value past sixteen bytes;comment\n"
+		";hidden=value\n"
+		"[Group] ; a comment after a group\n"
+		"key=value\n";
+	IniDocument document(text.data(), text.size());
+	const IniSection& global = document.getSections().front();
+	CHECK(global.name.empty());
+	CHECK(global.entries.size() == 3);
+	CHECK(getValue(document, "", "plain") == "value");
+	CHECK(getValue(document, "", "tight") == "a");
+	CHECK(getValue(document, "", "long_key_past_sixteen_bytes")
+		== "long value past sixteen bytes");
+	CHECK(!global.hasKey(";hidden") && !global.hasKey("hidden"));
+	CHECK(getValue(document, "Group", "key") == "value");
+}
+
+static void testEscapes() {
+	std::string text =
+		"semicolon=a\\;b\n"
+		"newline=line\\nbreak\n"
+		"return=a\\rb\n"
+		"backslash=back\\\\slash\n"
+		"literal=\\x\\[\n"
+		"equals\\=key=value\n"
+		"trailing=ends\\\n"
+		"trailing_crlf=ends\\\r\n"
+		"comment_after_escape=a\\;b;c\n"
+		"long_escaped_key_past_sixteen_bytes=value with a \\; past sixteen bytes\n";
+	IniDocument document(text.data(), text.size());
+	CHECK(getValue(document, "", "semicolon") == "a;b");
+	CHECK(getValue(document, "", "newline") == "line\nbreak");
+	CHECK(getValue(document, "", "return") == "a\rb");
+	CHECK(getValue(document, "", "backslash") == "back\\slash");
+	CHECK(getValue(document, "", "literal") == "x[");
+	CHECK(getValue(document, "", "equals=key") == "value");
+	// A backslash ending a line has nothing to escape, and is kept.
+	CHECK(getValue(document, "", "trailing") == "ends\\");
+	CHECK(getValue(document, "", "trailing_crlf") == "ends\\");
+	CHECK(getValue(document, "", "comment_after_escape") == "a;b");
+	CHECK(getValue(document, "", "long_escaped_key_past_sixteen_bytes")
+		== "value with a ; past sixteen bytes");
+}
+
+static void testRepeats() {
+	std::string text =
+		"[Level]\r\n"
+		"key=first\r\n"
+		"key=second\r\n"
+		"flag\r\n"
+		"\r\n"
+		"[Other]\r\n"
+		"key=other\r\n"
+		"[Level]\r\n"
+		"key=third\r\n"
+		"added=yes\r\n";
+	IniDocument document(text.data(), text.size());
+	// The global section, then each group once, in file order.
+	CHECK(document.getSections().size() == 3);
+	const IniSection* level = document.findSection("Level");
+	CHECK(level != nullptr);
+	if (level == nullptr) {
+		return;
+	}
+	// The first value of a repeated key wins, and repeated groups merge.
+	CHECK(level->getValue("key") == "first");
+	CHECK(level->getValue("added") == "yes");
+	CHECK(level->hasKey("flag") && level->getValue("flag").empty());
+	CHECK(level->lineNumber == 1);
+	CHECK(level->find("added")->lineNumber == 10);
+	CHECK(level->blocks.size() == 2);
+	CHECK(level->blocks.size() == 2 && level->blocks[1] == "key=third\r\nadded=yes\r\n");
+	CHECK(getValue(document, "Other", "key") == "other");
+	CHECK(document.findSection("Missing") == nullptr);
+}
+
+static void timeParse() {
+	std::string text;
+	for (int i = 0; i < SPLINE_POINTS; i++) {
+		text += "[" + std::to_string(i) + "]\r\n"
+			"Position=" + std::to_string(i) + ".25, -1250.5, 3000.125\r\n"
+			"Distance=12.5 ; a comment\r\n"
+			"XRotation=0x1000\r\n"
+			"ZRotation=0x2000\r\n";
+	}
+	auto start = std::chrono::steady_clock::now();
+	IniDocument document(text.data(), text.size());
+	double seconds = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+	CHECK(document.getSections().size() == SPLINE_POINTS + 1);
+	CHECK(getValue(document, "199999", "Distance") == "12.5");
+	std::printf("Parsed %.1f MB of ini text at %.0f MB/s\n",
+		text.size() / 1e6, text.size() / 1e6 / seconds);
+}
+
+int main() {
+	testComments();
+	testEscapes();
+	testRepeats();
+	timeParse();
+	return finishTests("IniDocumentTests");
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
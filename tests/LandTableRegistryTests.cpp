@@ -0,0 +1,89 @@
+/**
+ * LandTableRegistryTests.cpp
+ *
+ * Description:
+ *    Resolves land tables through a stand-in symbol table, checking that
+ *    missing exports come back as nullptr and that each name is looked up
+ *    in the symbol table only once.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "LandTableRegistry.h"
+#include "TestSupport.h"
+#include <string>
+#include <unordered_map>
+
+#define RESOLVE_COUNT 100
+
+/* A symbol table of a few land tables, counting the lookups of each name. */
+class FakeSymbolTable : public SymbolTable {
+	public:
+		void* findSymbol(const std::string& name) const override {
+			lookupCounts[name]++;
+			auto it = symbols.find(name);
+			return it == symbols.end() ? nullptr : it->second;
+		}
+
+		std::unordered_map<std::string, void*> symbols;
+		mutable std::unordered_map<std::string, int> lookupCounts;
+};
+
+static void testResolve() {
+	LandTable greenForest = {};
+	LandTable cityEscape = {};
+	FakeSymbolTable symbolTable;
+	symbolTable.symbols["objLandTable0013"] = &greenForest;
+	symbolTable.symbols["objLandTable0010"] = &cityEscape;
+	LandTableRegistry registry(symbolTable);
+
+	CHECK(registry.find("objLandTable0013") == nullptr);
+	for (int i = 0; i < RESOLVE_COUNT; i++) {
+		CHECK(registry.resolve("objLandTable0013") == &greenForest);
+		CHECK(registry.resolve("objLandTable0010") == &cityEscape);
+	}
+	CHECK(registry.find("objLandTable0013") == &greenForest);
+	CHECK(registry.find("objLandTable0010") == &cityEscape);
+	CHECK(symbolTable.lookupCounts["objLandTable0013"] == 1);
+	CHECK(symbolTable.lookupCounts["objLandTable0010"] == 1);
+}
+
+static void testMissingSymbols() {
+	FakeSymbolTable symbolTable;
+	LandTableRegistry registry(symbolTable);
+
+	// Missing names warn once, and are remembered as missing.
+	for (int i = 0; i < RESOLVE_COUNT; i++) {
+		CHECK(registry.resolve("objLandTableMissing") == nullptr);
+	}
+	CHECK(registry.find("objLandTableMissing") == nullptr);
+	CHECK(symbolTable.lookupCounts["objLandTableMissing"] == 1);
+	// Finding a name never looks it up.
+	CHECK(registry.find("objLandTableUnresolved") == nullptr);
+	CHECK(symbolTable.lookupCounts.count("objLandTableUnresolved") == 0);
+}
+
+int main() {
+	testResolve();
+	testMissingSymbols();
+	return finishTests("LandTableRegistryTests");
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
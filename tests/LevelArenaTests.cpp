@@ -0,0 +1,118 @@
+/**
+ * LevelArenaTests.cpp
+ *
+ * Description:
+ *    Plays 1,000 simulated level load and free cycles through a LevelArena,
+ *    counting heap allocations to check that loads stay cheap and that
+ *    freeing a level gives everything back.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "LevelArena.h"
+#include "TestSupport.h"
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#define CYCLE_COUNT 1000
+#define SPLINE_COUNT 20
+#define POINTS_PER_SPLINE 200
+// Bigger than a chunk, so it gets a chunk of its own.
+#define LONG_SPLINE_POINTS 5000
+
+/* Allocates what a level load puts in its arena. */
+static void loadLevel(LevelArena& arena) {
+	NJS_TEXLIST* texList = arena.allocate<NJS_TEXLIST>();
+	texList->textures = arena.allocate<NJS_TEXNAME>(300);
+	texList->nbTexture = 300;
+	char* textureName = arena.copyString("greenforest");
+	CHECK(std::string(textureName) == "greenforest");
+
+	LoopHead** splines = arena.allocate<LoopHead*>(SPLINE_COUNT + 2);
+	for (int i = 0; i < SPLINE_COUNT; i++) {
+		splines[i] = arena.allocate<LoopHead>();
+		splines[i]->Count = POINTS_PER_SPLINE;
+		splines[i]->Points = arena.allocate<LoopPoint>(POINTS_PER_SPLINE);
+		CHECK((uintptr_t)splines[i]->Points % alignof(LoopPoint) == 0);
+		CHECK(splines[i]->Points[POINTS_PER_SPLINE - 1].Distance == 0);
+	}
+	splines[SPLINE_COUNT] = arena.allocate<LoopHead>();
+	splines[SPLINE_COUNT]->Points = arena.allocate<LoopPoint>(LONG_SPLINE_POINTS);
+}
+
+static void testLoadFreeCycles() {
+	size_t firstCycleHeapCalls = 0;
+	size_t liveAllocations = getLiveAllocationCount();
+	for (int cycle = 0; cycle < CYCLE_COUNT; cycle++) {
+		size_t allocationCount = getAllocationCount();
+		{
+			LevelArena arena;
+			loadLevel(arena);
+			CHECK(arena.getAllocationCount() == 4 + 2 * SPLINE_COUNT + 2);
+			CHECK(arena.getBytesUsed() >= LONG_SPLINE_POINTS * sizeof(LoopPoint));
+			size_t heapCalls = getAllocationCount() - allocationCount;
+			if (cycle == 0) {
+				firstCycleHeapCalls = heapCalls;
+				// One heap call per chunk, plus the chunk list growing.
+				std::printf("%zu heap calls for %zu arena allocations in %zu chunk(s)\n",
+					heapCalls, arena.getAllocationCount(), arena.getChunkCount());
+				CHECK(heapCalls <= 2 * arena.getChunkCount());
+			}
+			CHECK(heapCalls == firstCycleHeapCalls);
+		}
+		CHECK(getLiveAllocationCount() == liveAllocations);
+	}
+}
+
+static void testMappedFiles() {
+	std::filesystem::path path =
+		std::filesystem::temp_directory_path() / "LevelArenaTests.bin";
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << "SA2P";
+	}
+	size_t liveAllocations = getLiveAllocationCount();
+	{
+		LevelArena arena;
+		const MappedFile* mappedFile = arena.mapFile(path);
+		CHECK(mappedFile != nullptr && mappedFile->size() == 4);
+		if (mappedFile != nullptr) {
+			// Mapped copy on write, so the level may patch it in place.
+			mappedFile->mutableData()[0] = 'X';
+			CHECK(mappedFile->data()[0] == 'X');
+		}
+		CHECK(arena.mapFile(path.string() + ".missing") == nullptr);
+	}
+	CHECK(getLiveAllocationCount() == liveAllocations);
+	std::ifstream file(path, std::ios::binary);
+	CHECK(file.get() == 'S');
+	file.close();
+	std::filesystem::remove(path);
+}
+
+int main() {
+	testLoadFreeCycles();
+	testMappedFiles();
+	return finishTests("LevelArenaTests");
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,129 @@
+/**
+ * OptionsPathTests.cpp
+ *
+ * Description:
+ *    Tests the level options path taken on every level load: indexed
+ *    requests are parsed once, and resolving them again makes no heap
+ *    allocations and no copies. Also checks the options cache round trip.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "AssetIndex.h"
+#include "IniReader.h"
+#include "LevelOptionsIndex.h"
+#include "TestSupport.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#define LOAD_COUNT 1000
+
+static const char* OPTIONS_FILE =
+	"[Green Forest]\n"
+	"level_id=13\n"
+	"level_file_name=forest.sa2blvl\n"
+	"pak_file_name=forest.pak\n"
+	"spline_file_names=rail1, rail2\n"
+	"spawn_coordinates=1, 2, 3\n"
+	"victory_coordinates=4, 5, 6\n"
+	"simple_death_plane=-500\n"
+	"\n"
+	"[Garden]\n"
+	"land_table_name=objLandTableGarden\n"
+	"level_file_name=garden.sa2blvl\n"
+	"pak_file_name=garden.pak\n";
+
+static bool equalPositions(const NJS_VECTOR& a, const NJS_VECTOR& b) {
+	return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+static void testIndexedLoads(const char* modPath, const AssetIndex& assetIndex) {
+	IniReader iniReader(modPath, assetIndex);
+	std::vector<ImportRequest> requests = iniReader.readLevelOptions();
+	CHECK(requests.size() == 2);
+	if (requests.size() != 2) {
+		return;
+	}
+	const ImportRequest& forest = requests[0];
+	CHECK(forest.optionsIndex != nullptr);
+	CHECK(forest.levelID == LevelIDs_GreenForest);
+	CHECK(requests[1].landTableName == "objLandTableGarden");
+	// Positions are known from indexing alone, to be registered at Init.
+	CHECK(equalPositions(forest.levelOptions.startPosition, { 1, 2, 3 }));
+	CHECK(equalPositions(forest.levelOptions.endPosition, { 4, 5, 6 }));
+
+	int completeCount = 0;
+	auto complete = [&completeCount](ImportRequest&) { completeCount++; };
+	const ImportRequest& parsed = forest.optionsIndex->resolve(forest, complete);
+	CHECK(parsed.pakFileName == "forest.pak");
+	CHECK(parsed.levelOptions.simpleDeathPlane == -500);
+	CHECK(parsed.levelOptions.splineFileNames.size() == 2);
+	CHECK(forest.optionsIndex->takeWarnings(forest.optionsSection).empty());
+
+	// Later loads of the level reuse the parsed request as is.
+	size_t allocationCount = getAllocationCount();
+	bool sameRequest = true;
+	for (int i = 0; i < LOAD_COUNT; i++) {
+		const ImportRequest& request = forest.optionsIndex->resolve(forest, complete);
+		sameRequest = sameRequest && &request == &parsed;
+	}
+	CHECK(getAllocationCount() == allocationCount);
+	CHECK(sameRequest);
+	CHECK(completeCount == 1);
+}
+
+static void testCachedOptions(const char* modPath, const AssetIndex& assetIndex) {
+	IniReader iniReader(modPath, assetIndex);
+	std::vector<ImportRequest> requests = iniReader.readLevelOptions();
+	CHECK(requests.size() == 2);
+	if (requests.size() != 2) {
+		return;
+	}
+	// The index pass saved the cache, though the garden was never loaded.
+	// Cached requests are complete, with no section left to parse.
+	CHECK(requests[0].optionsIndex == nullptr);
+	CHECK(requests[0].levelFileName == "forest.sa2blvl");
+	CHECK(requests[0].levelOptions.simpleDeathPlane == -500);
+	CHECK(equalPositions(requests[0].levelOptions.endPosition, { 4, 5, 6 }));
+	CHECK(requests[1].pakFileName == "garden.pak");
+}
+
+int main() {
+	std::filesystem::path tempPath =
+		std::filesystem::temp_directory_path() / "OptionsPathTests";
+	std::filesystem::remove_all(tempPath);
+	std::filesystem::create_directories(tempPath / "mod");
+	std::string modPath = (tempPath / "mod").string();
+	{
+		// IniReader joins the path with a backslash, which is only a
+		// separator on Windows; elsewhere it is part of the file name.
+		std::ofstream file(modPath + "\\level_options.ini", std::ios::binary);
+		file << OPTIONS_FILE;
+	}
+	AssetIndex assetIndex(modPath.c_str());
+	testIndexedLoads(modPath.c_str(), assetIndex);
+	testCachedOptions(modPath.c_str(), assetIndex);
+	std::filesystem::remove_all(tempPath);
+	return finishTests("OptionsPathTests");
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,212 @@
+/**
+ * SplineLayoutTests.cpp
+ *
+ * Description:
+ *    Checks how readSplines lays out a level's splines: levels share the
+ *    pooled splines instead of copying them, copies of a file are listed
+ *    once, .sa2path points stay in their mapped file, and a spline is freed
+ *    once no level holds it. Also walks every point the way the game does,
+ *    counting heap allocations and timing the walk.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "AssetIndex.h"
+#include "IniReader.h"
+#include "LevelArena.h"
+#include "SplinePool.h"
+#include "TestSupport.h"
+#include "WorkerPool.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define POINTS_PER_SPLINE 500
+#define WALK_COUNT 1000
+
+/* A level's spline array and the pooled splines it points into. */
+struct LevelSplines {
+	LevelArena arena;
+	std::vector<std::shared_ptr<SharedSpline>> sharedSplines;
+	LoopHead** splines = nullptr;
+};
+
+static void writeSplineIni(const std::filesystem::path& path, int code) {
+	std::ofstream file(path, std::ios::binary);
+	file << "Code=" << std::hex << code << std::dec << "\n";
+	for (int point = 0; point < POINTS_PER_SPLINE; point++) {
+		file << "[" << point << "]\nPosition=" << code << ", " << point << ", 0\n"
+			"Distance=1\n";
+	}
+}
+
+static void makeModFolder(const std::filesystem::path& modPath) {
+	std::filesystem::path pathsPath = modPath / "gd_PC" / "Paths";
+	std::filesystem::create_directories(pathsPath);
+	writeSplineIni(pathsPath / "rail0.ini", 10);
+	writeSplineIni(pathsPath / "rail1.ini", 11);
+	// The same contents as rail1, under another name.
+	std::filesystem::copy_file(pathsPath / "rail1.ini", pathsPath / "rail1copy.ini");
+	// A .sa2path spline with no ini file.
+	writeSplineIni(modPath / "binary.ini", 12);
+	LevelArena arena;
+	LoopHead* spline = IniReader::readSpline((modPath / "binary.ini").string(), arena, false);
+	CHECK(spline != nullptr);
+	if (spline != nullptr) {
+		CHECK(IniReader::writeBinarySpline(*spline, pathsPath / "binary.sa2path", 0));
+	}
+}
+
+static void readLevel(IniReader& iniReader, WorkerPool& workerPool,
+		SplinePool& splinePool, std::vector<std::string> splineFileNames,
+		bool recomputeMetrics, LevelSplines& level) {
+	level.splines = iniReader.readSplines(splineFileNames, recomputeMetrics,
+		level.arena, workerPool, splinePool, level.sharedSplines, false);
+}
+
+static LoopHead* findSpline(const LevelSplines& level, int code) {
+	for (size_t i = 0; level.splines != nullptr && level.splines[i] != nullptr; i++) {
+		if ((uintptr_t)level.splines[i]->Object == (uintptr_t)code) {
+			return level.splines[i];
+		}
+	}
+	return nullptr;
+}
+
+static size_t countSplines(const LevelSplines& level) {
+	size_t count = 0;
+	while (level.splines != nullptr && level.splines[count] != nullptr) {
+		count++;
+	}
+	return count;
+}
+
+/* Walks every point of every spline in array order, as the game does. */
+static float walkPoints(LoopHead** splines) {
+	float total = 0;
+	for (size_t i = 0; splines[i] != nullptr; i++) {
+		const LoopHead* spline = splines[i];
+		for (int point = 0; point < spline->Count; point++) {
+			total += spline->Points[point].Position.y + spline->Points[point].Distance;
+		}
+	}
+	return total;
+}
+
+static void testSharedLayout(IniReader& iniReader, WorkerPool& workerPool) {
+	SplinePool splinePool;
+	auto levelA = std::make_unique<LevelSplines>();
+	size_t allocationCount = getAllocationCount();
+	readLevel(iniReader, workerPool, splinePool,
+		{ "rail0", "rail1", "rail1copy", "binary" }, false, *levelA);
+	size_t firstReadAllocations = getAllocationCount() - allocationCount;
+	// The copy of rail1 has the same contents, so it is only listed once.
+	CHECK(countSplines(*levelA) == 3);
+	CHECK(levelA->sharedSplines.size() == 3);
+
+	auto levelB = std::make_unique<LevelSplines>();
+	allocationCount = getAllocationCount();
+	readLevel(iniReader, workerPool, splinePool, { "rail1", "binary" }, false, *levelB);
+	size_t pooledReadAllocations = getAllocationCount() - allocationCount;
+	CHECK(countSplines(*levelB) == 2);
+	std::printf("Reading 3 splines made %zu heap allocations, reading 2 of "
+		"them again from the pool made %zu\n", firstReadAllocations,
+		pooledReadAllocations);
+	CHECK(pooledReadAllocations < firstReadAllocations);
+
+	// Both levels point at the same spline and points, nothing is copied.
+	LoopHead* railA = findSpline(*levelA, 11);
+	LoopHead* railB = findSpline(*levelB, 11);
+	CHECK(railA != nullptr && railA == railB);
+	LoopHead* binaryA = findSpline(*levelA, 12);
+	LoopHead* binaryB = findSpline(*levelB, 12);
+	CHECK(binaryA != nullptr && binaryA == binaryB);
+	if (railA == nullptr || binaryA == nullptr) {
+		return;
+	}
+	CHECK(railA->Count == POINTS_PER_SPLINE);
+	CHECK(railA->Points[POINTS_PER_SPLINE - 1].Position.y == POINTS_PER_SPLINE - 1);
+
+	// .sa2path points are used where they are mapped, right after the
+	// file's header.
+	CHECK(binaryA->Count == POINTS_PER_SPLINE);
+	const BinarySplineHeader* header =
+		(const BinarySplineHeader*)((const char*)binaryA->Points - sizeof(BinarySplineHeader));
+	CHECK(std::memcmp(header->magic, SPLINE_MAGIC, 4) == 0);
+	CHECK(header->count == POINTS_PER_SPLINE);
+
+	// Recomputed splines are pooled apart, leaving the shared one as written.
+	auto recomputedLevel = std::make_unique<LevelSplines>();
+	readLevel(iniReader, workerPool, splinePool, { "rail1" }, true, *recomputedLevel);
+	LoopHead* recomputed = findSpline(*recomputedLevel, 11);
+	CHECK(recomputed != nullptr && recomputed != railA);
+	CHECK(railA->Points[0].Distance == 1);
+
+	auto start = std::chrono::steady_clock::now();
+	allocationCount = getAllocationCount();
+	float total = 0;
+	for (int i = 0; i < WALK_COUNT; i++) {
+		total += walkPoints(levelA->splines);
+	}
+	CHECK(getAllocationCount() == allocationCount);
+	CHECK(total > 0);
+	std::printf("Walked %d points %d times in %.2f ms\n", 3 * POINTS_PER_SPLINE,
+		WALK_COUNT, std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - start).count());
+
+	// A pooled spline lives as long as a level holds it.
+	std::weak_ptr<SharedSpline> rail0 = levelA->sharedSplines.front();
+	std::weak_ptr<SharedSpline> rail1;
+	for (const std::shared_ptr<SharedSpline>& sharedSpline : levelA->sharedSplines) {
+		if (sharedSpline->spline == railA) {
+			rail1 = sharedSpline;
+		}
+	}
+	levelA.reset();
+	CHECK(!rail1.expired());
+	CHECK(railB->Points[0].Position.x == 11);
+	levelB.reset();
+	CHECK(rail0.expired());
+	CHECK(rail1.expired());
+}
+
+int main() {
+	std::filesystem::path modPath =
+		std::filesystem::temp_directory_path() / "SplineLayoutTests";
+	std::filesystem::remove_all(modPath);
+	makeModFolder(modPath);
+	{
+		AssetIndex assetIndex(modPath.string().c_str());
+		IniReader iniReader(modPath.string().c_str(), assetIndex);
+		// No pool threads, so the allocation counts, which are per thread,
+		// see every allocation of a read.
+		WorkerPool workerPool(0);
+		testSharedLayout(iniReader, workerPool);
+	}
+	std::filesystem::remove_all(modPath);
+	return finishTests("SplineLayoutTests");
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,150 @@
+/**
+ * SplineMetricsTests.cpp
+ *
+ * Description:
+ *    Tests that recomputeSplineMetrics gives the same distances and
+ *    rotations on its scalar, SSE and AVX paths, for every spline length
+ *    up to a few vectors and a 10,000 point spline, and prints the time
+ *    each path takes on the long spline.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "SplineMetrics.h"
+#include "TestSupport.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#define LONG_SPLINE_POINTS 10000
+#define TIMING_RUNS 100
+
+static const SplineMetricsPath PATHS[] = {
+	SplineMetricsPath::Scalar,
+	SplineMetricsPath::Sse,
+	SplineMetricsPath::Avx
+};
+static const char* PATH_NAMES[] = { "scalar", "SSE", "AVX" };
+
+/* Points wandering in every direction, the same on every run. */
+static std::vector<LoopPoint> makePoints(size_t count) {
+	std::vector<LoopPoint> points(count);
+	uint32_t state = 12345;
+	auto next = [&state]() {
+		state = state * 1664525 + 1013904223;
+		return (float)(state >> 8) / (1 << 24) * 200 - 100;
+	};
+	NJS_VECTOR position = { 0, 0, 0 };
+	for (LoopPoint& point : points) {
+		position.x += next();
+		position.y += next() / 4;
+		position.z += next();
+		point.Position = position;
+	}
+	return points;
+}
+
+static bool recompute(std::vector<LoopPoint>& points, SplineMetricsPath path,
+		float& totalDistance) {
+	LoopHead spline{};
+	spline.Count = (int16_t)points.size();
+	spline.Points = points.data();
+	bool ran = recomputeSplineMetrics(spline, path);
+	totalDistance = spline.TotalDistance;
+	return ran;
+}
+
+static bool samePoints(const std::vector<LoopPoint>& a, const std::vector<LoopPoint>& b) {
+	for (size_t i = 0; i < a.size(); i++) {
+		if (a[i].Distance != b[i].Distance || a[i].XRot != b[i].XRot
+				|| a[i].YRot != b[i].YRot) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void testKnownMetrics() {
+	// Along z, then straight up, with the last point copying the one before.
+	std::vector<LoopPoint> points(4);
+	points[1].Position = { 0, 0, 3 };
+	points[2].Position = { 0, 0, 6 };
+	points[3].Position = { 0, 4, 6 };
+	float totalDistance;
+	CHECK(recompute(points, SplineMetricsPath::Scalar, totalDistance));
+	CHECK(totalDistance == 10);
+	CHECK(points[0].Distance == 3 && points[0].XRot == 0 && points[0].YRot == 0);
+	CHECK(points[2].Distance == 4 && points[2].XRot == -16384);
+	CHECK(points[3].Distance == 0 && points[3].XRot == points[2].XRot);
+}
+
+static void testPathsMatch() {
+	CHECK(canUseSplineMetricsPath(SplineMetricsPath::Scalar));
+	// Every length up to a few vectors, so each path's padding is covered.
+	std::vector<size_t> counts;
+	for (size_t count = 0; count <= 33; count++) {
+		counts.push_back(count);
+	}
+	counts.push_back(LONG_SPLINE_POINTS);
+	for (size_t count : counts) {
+		std::vector<LoopPoint> expected = makePoints(count);
+		float expectedTotal;
+		recompute(expected, SplineMetricsPath::Scalar, expectedTotal);
+		for (SplineMetricsPath path : PATHS) {
+			std::vector<LoopPoint> points = makePoints(count);
+			float totalDistance;
+			if (!recompute(points, path, totalDistance)) {
+				CHECK(!canUseSplineMetricsPath(path));
+				continue;
+			}
+			CHECK(samePoints(points, expected));
+			CHECK(totalDistance == expectedTotal);
+		}
+	}
+}
+
+static void timePaths() {
+	std::vector<LoopPoint> points = makePoints(LONG_SPLINE_POINTS);
+	for (size_t i = 0; i < 3; i++) {
+		if (!canUseSplineMetricsPath(PATHS[i])) {
+			std::printf("%s: not available\n", PATH_NAMES[i]);
+			continue;
+		}
+		float totalDistance;
+		auto start = std::chrono::steady_clock::now();
+		for (int run = 0; run < TIMING_RUNS; run++) {
+			recompute(points, PATHS[i], totalDistance);
+		}
+		std::printf("%s: %.3f ms per %d point spline\n", PATH_NAMES[i],
+			std::chrono::duration<double, std::milli>(
+				std::chrono::steady_clock::now() - start).count() / TIMING_RUNS,
+			LONG_SPLINE_POINTS);
+	}
+}
+
+int main() {
+	testKnownMetrics();
+	testPathsMatch();
+	timePaths();
+	return finishTests("SplineMetricsTests");
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,165 @@
+/**
+ * SplineParserTests.cpp
+ *
+ * Description:
+ *    Reads spline ini files through IniReader::readSpline, checking the
+ *    parsed header and points of a full 9,999 point spline, where the point
+ *    list ends, and that errors give the line they were found on. Also
+ *    prints how long the full spline takes to parse.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "IniReader.h"
+#include "LevelArena.h"
+#include "TestSupport.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#define PARSE_COUNT 10
+
+static std::string writeSpline(const std::string& name, const std::string& text) {
+	std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file << text;
+	return path.string();
+}
+
+static bool hasLastMessage(const std::string& text) {
+	return getLastDebugMessage().find(text) != std::string::npos;
+}
+
+static void testFullSpline() {
+	std::string text =
+		"; Written by a level editor\r\n"
+		"Code=497130\r\n"
+		"TotalDistance=1234.5\r\n"
+		"Unknown=3\r\n";
+	// Points listed last to first, which must not change their order.
+	for (int i = MAX_SPLINE_POINTS - 1; i >= 0; i--) {
+		text += "[" + std::to_string(i) + "]\r\n"
+			"XRotation=" + std::to_string(i % 10) + "00\r\n"
+			"ZRotation=0x" + std::to_string(i % 7) + "0\r\n"
+			"Distance=" + std::to_string(i) + ".5\r\n"
+			"Position=" + std::to_string(i) + ", " + std::to_string(2 * i) +
+				".25, -" + std::to_string(i) + " ; a comment\r\n";
+	}
+	std::string path = writeSpline("SplineParserTests_full.ini", text);
+	LevelArena arena;
+	LoopHead* spline = IniReader::readSpline(path, arena, false);
+	CHECK(spline != nullptr);
+	if (spline == nullptr) {
+		return;
+	}
+	CHECK(spline->Count == MAX_SPLINE_POINTS);
+	CHECK(spline->TotalDistance == 1234.5f);
+	CHECK(spline->anonymous_0 == 3);
+	CHECK((uintptr_t)spline->Object == 0x497130);
+	bool pointsMatch = true;
+	for (int i = 0; i < spline->Count; i++) {
+		const LoopPoint& point = spline->Points[i];
+		pointsMatch = pointsMatch
+			&& point.XRot == (int16_t)((i % 10) * 0x100)
+			&& point.YRot == (int16_t)((i % 7) * 0x10)
+			&& point.Distance == i + 0.5f
+			&& point.Position.x == (float)i
+			&& point.Position.y == 2 * i + 0.25f
+			&& point.Position.z == (float)-i;
+	}
+	CHECK(pointsMatch);
+
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < PARSE_COUNT; i++) {
+		LevelArena timedArena;
+		CHECK(IniReader::readSpline(path, timedArena, false) != nullptr);
+	}
+	std::printf("Parsed a %d point spline in %.2f ms\n", MAX_SPLINE_POINTS,
+		std::chrono::duration<double, std::milli>(
+			std::chrono::steady_clock::now() - start).count() / PARSE_COUNT);
+	std::filesystem::remove(path);
+}
+
+static void testPointList() {
+	LevelArena arena;
+	// The points end at the first missing index, and groups that aren't an
+	// index are ignored.
+	std::string path = writeSpline("SplineParserTests_gap.ini",
+		"Code=1\n"
+		"[0]\nPosition=0, 0, 0\n"
+		"[Notes]\nPosition=9, 9, 9\n"
+		"[1]\nPosition=1, 0, 0\n"
+		"[3]\nPosition=3, 0, 0\n");
+	LoopHead* spline = IniReader::readSpline(path, arena, false);
+	CHECK(spline != nullptr && spline->Count == 2);
+	CHECK(spline != nullptr && spline->Points[1].Position.x == 1);
+	// Points past the game's limit are left out.
+	std::string text = "Code=1\n";
+	for (int i = 0; i < MAX_SPLINE_POINTS + 2; i++) {
+		text += "[" + std::to_string(i) + "]\nPosition=0, 0, 0\n";
+	}
+	path = writeSpline("SplineParserTests_gap.ini", text);
+	spline = IniReader::readSpline(path, arena, false);
+	CHECK(spline != nullptr && spline->Count == MAX_SPLINE_POINTS);
+	// The default of Unknown, which SA2 needs to be 1.
+	CHECK(spline != nullptr && spline->anonymous_0 == 1);
+	std::filesystem::remove(path);
+}
+
+static void testErrors() {
+	LevelArena arena;
+	std::string path = writeSpline("SplineParserTests_error.ini",
+		"Code=1\n"
+		"[0]\n"
+		"Position=0, 0, 0\n"
+		"[1]\n"
+		"Position=1, 0\n");
+	CHECK(IniReader::readSpline(path, arena, false) == nullptr);
+	CHECK(hasLastMessage("\"Position\" value \"1, 0\" on line 5"));
+
+	path = writeSpline("SplineParserTests_error.ini",
+		"Code=1\n"
+		"[0]\n"
+		"Distance=far\n");
+	CHECK(IniReader::readSpline(path, arena, false) == nullptr);
+	CHECK(hasLastMessage("on line 3"));
+
+	path = writeSpline("SplineParserTests_error.ini",
+		"TotalDistance=10\n"
+		"[0]\n"
+		"Position=0, 0, 0\n");
+	CHECK(IniReader::readSpline(path, arena, false) == nullptr);
+	CHECK(hasLastMessage("missing the \"Code\" field"));
+
+	std::filesystem::remove(path);
+	CHECK(IniReader::readSpline(path, arena, false) == nullptr);
+	CHECK(hasLastMessage("Could not read the spline"));
+}
+
+int main() {
+	testFullSpline();
+	testPointList();
+	testErrors();
+	return finishTests("SplineParserTests");
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,126 @@
+/**
+ * SplineSamplerTests.cpp
+ *
+ * Description:
+ *    Tests SplineSampler's distance sampling against known rails, and its
+ *    nearest point search against a brute force search.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "SplineSampler.h"
+#include "TestSupport.h"
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#define QUERY_COUNT 2000
+
+static LoopHead makeSpline(std::vector<LoopPoint>& points) {
+	LoopHead spline{};
+	spline.Count = (int16_t)points.size();
+	spline.Points = points.data();
+	return spline;
+}
+
+static float squaredDistance(const NJS_VECTOR& a, const NJS_VECTOR& b) {
+	float dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+	return dx * dx + dy * dy + dz * dz;
+}
+
+static void testStraightRail() {
+	// Points 0, 1, 3 and 6 units along x, with stale Distance values.
+	std::vector<LoopPoint> points(4);
+	float xs[] = { 0, 1, 3, 6 };
+	for (size_t i = 0; i < points.size(); i++) {
+		points[i].Position = { xs[i], 2, 0 };
+		points[i].Distance = 100;
+	}
+	LoopHead spline = makeSpline(points);
+	SplineSampler sampler(spline);
+	CHECK(sampler.getLength() == 6);
+	CHECK(sampler.getPointDistance(2) == 3);
+	CHECK(sampler.findSegment(0) == 0);
+	CHECK(sampler.findSegment(2) == 1);
+	CHECK(sampler.findSegment(4.5f) == 2);
+	CHECK(sampler.sample(4.5f).x == 4.5f && sampler.sample(4.5f).y == 2);
+	// Distances outside the rail are clamped to its ends.
+	CHECK(sampler.sample(-10).x == 0);
+	CHECK(sampler.sample(1000).x == 6);
+	CHECK(sampler.findNearestPoint({ 2.9f, 50, 0 }) == 2);
+}
+
+static void testNearestPoints() {
+	// A long winding rail, up to the game's point limit.
+	std::vector<LoopPoint> points(9999);
+	for (size_t i = 0; i < points.size(); i++) {
+		float radius = 500 + i * 0.01f;
+		points[i].Position = {
+			std::cos(i * 0.001f) * radius,
+			std::sin(i * 0.003f) * 50,
+			std::sin(i * 0.001f) * radius
+		};
+	}
+	LoopHead spline = makeSpline(points);
+	SplineSampler sampler(spline);
+
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> coordinate(-700, 700);
+	size_t allocationCount = getAllocationCount();
+	size_t mismatchCount = 0;
+	for (int query = 0; query < QUERY_COUNT; query++) {
+		NJS_VECTOR position = { coordinate(random), coordinate(random) / 10, coordinate(random) };
+		float nearestDistance = INFINITY;
+		for (const LoopPoint& point : points) {
+			nearestDistance = std::fmin(nearestDistance, squaredDistance(point.Position, position));
+		}
+		size_t nearestPoint = sampler.findNearestPoint(position);
+		if (squaredDistance(points[nearestPoint].Position, position) != nearestDistance) {
+			mismatchCount++;
+		}
+		sampler.sample(query * 7.3f);
+	}
+	CHECK(mismatchCount == 0);
+	// Queries run every frame, so they must never allocate.
+	CHECK(getAllocationCount() == allocationCount);
+
+	for (size_t i = 0; i < points.size(); i += 97) {
+		NJS_VECTOR position = sampler.sample(sampler.getPointDistance(i));
+		CHECK(squaredDistance(position, points[i].Position) < 1e-4f);
+	}
+}
+
+static void testEmptyRail() {
+	std::vector<LoopPoint> points;
+	LoopHead spline = makeSpline(points);
+	SplineSampler sampler(spline);
+	CHECK(sampler.findNearestPoint({ 0, 0, 0 }) == SIZE_MAX);
+	CHECK(sampler.getLength() == 0);
+}
+
+int main() {
+	testStraightRail();
+	testNearestPoints();
+	testEmptyRail();
+	return finishTests("SplineSamplerTests");
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
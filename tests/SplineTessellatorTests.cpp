@@ -0,0 +1,154 @@
+/**
+ * SplineTessellatorTests.cpp
+ *
+ * Description:
+ *    Tests that tessellated rails pass through their control points, stay
+ *    straight where the control points are, and only swing a little past
+ *    sharp turns.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "IniReader.h"
+#include "LevelArena.h"
+#include "SplineMetrics.h"
+#include "SplineTessellator.h"
+#include "TestSupport.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static std::vector<LoopPoint> makeControlPoints(std::vector<NJS_VECTOR> positions) {
+	std::vector<LoopPoint> controlPoints(positions.size());
+	for (size_t i = 0; i < positions.size(); i++) {
+		controlPoints[i].Position = positions[i];
+	}
+	return controlPoints;
+}
+
+static std::vector<LoopPoint> tessellate(const std::vector<LoopPoint>& controlPoints, int density) {
+	std::vector<LoopPoint> points(getTessellatedPointCount(controlPoints.size(), density));
+	tessellateSpline(controlPoints.data(), controlPoints.size(), density, points.data());
+	return points;
+}
+
+static bool isClose(const NJS_VECTOR& a, const NJS_VECTOR& b) {
+	return std::fabs(a.x - b.x) < 1e-4f && std::fabs(a.y - b.y) < 1e-4f
+		&& std::fabs(a.z - b.z) < 1e-4f;
+}
+
+static void testControlPoints() {
+	// Covers an odd density, so the last SSE batch is partly filled.
+	std::vector<LoopPoint> controlPoints = makeControlPoints(
+		{ { 0, 0, 0 }, { 10, 0, 0 }, { 20, 5, 10 }, { 40, 0, 10 }, { 45, -3, 2 } });
+	int density = 7;
+	std::vector<LoopPoint> points = tessellate(controlPoints, density);
+	CHECK(points.size() == (controlPoints.size() - 1) * density + 1);
+	for (size_t i = 0; i < controlPoints.size(); i++) {
+		CHECK(isClose(points[i * density].Position, controlPoints[i].Position));
+	}
+
+	LoopHead spline{};
+	spline.Count = (int16_t)points.size();
+	spline.Points = points.data();
+	recomputeSplineMetrics(spline);
+	CHECK(std::isfinite(spline.TotalDistance) && spline.TotalDistance > 0);
+}
+
+static void testStraightRail() {
+	std::vector<LoopPoint> controlPoints =
+		makeControlPoints({ { 0, 0, 0 }, { 1, 0, 0 }, { 5, 0, 0 }, { 6, 0, 0 } });
+	bool straight = true;
+	bool ordered = true;
+	std::vector<LoopPoint> points = tessellate(controlPoints, 16);
+	for (size_t i = 0; i < points.size(); i++) {
+		straight = straight && points[i].Position.y == 0 && points[i].Position.z == 0;
+		ordered = ordered && (i == 0 || points[i].Position.x >= points[i - 1].Position.x);
+	}
+	// Uneven spacing bends uniform Catmull-Rom curves back on themselves.
+	CHECK(straight);
+	CHECK(ordered);
+}
+
+static void testSharpTurn() {
+	std::vector<LoopPoint> points = tessellate(
+		makeControlPoints({ { 0, 0, 0 }, { 10, 0, 0 }, { 10, 0, 10 } }), 64);
+	float lowestZ = 0;
+	float highestX = 0;
+	for (const LoopPoint& point : points) {
+		lowestZ = std::min(lowestZ, point.Position.z);
+		highestX = std::max(highestX, point.Position.x);
+	}
+	// See tessellateSpline, the curve swings about 0.74 past the corner, the
+	// same on both legs.
+	CHECK(lowestZ < -0.7f && lowestZ > -0.8f);
+	CHECK(highestX > 10.7f && highestX < 10.8f);
+}
+
+static void testRepeatedControlPoints() {
+	// Repeated points must not divide by a zero length segment.
+	std::vector<LoopPoint> points = tessellate(makeControlPoints(
+		{ { 0, 0, 0 }, { 10, 0, 0 }, { 10, 0, 0 }, { 20, 5, 10 } }), 5);
+	bool finite = true;
+	for (const LoopPoint& point : points) {
+		finite = finite && std::isfinite(point.Position.x)
+			&& std::isfinite(point.Position.y) && std::isfinite(point.Position.z);
+	}
+	CHECK(finite);
+}
+
+/* Writes a spline ini file with 5 control points and the given density. */
+static std::filesystem::path writeSplineFile(const std::string& density) {
+	std::filesystem::path path =
+		std::filesystem::temp_directory_path() / "SplineTessellatorTests.ini";
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file << "Code=497130\nDensity=" << density << "\n";
+	for (int i = 0; i < 5; i++) {
+		file << "[" << i << "]\nPosition=" << i * 10 << ", 0, 0\n";
+	}
+	return path;
+}
+
+static void testHugeDensities() {
+	// 4 segments of 2^30 points wrap a 32 bit count around to 1.
+	CHECK(getTessellatedPointCount(5, 1073741824) == 4294967297ULL);
+	for (const char* density : { "1073741824", "2147483647", "10000", "2500" }) {
+		LevelArena arena;
+		CHECK(IniReader::readSpline(writeSplineFile(density).string(), arena, false) == nullptr);
+	}
+	LevelArena arena;
+	LoopHead* spline = IniReader::readSpline(writeSplineFile("2499").string(), arena, false);
+	CHECK(spline != nullptr && spline->Count == 4 * 2499 + 1);
+	std::filesystem::remove(writeSplineFile("1"));
+}
+
+int main() {
+	testControlPoints();
+	testStraightRail();
+	testSharpTurn();
+	testRepeatedControlPoints();
+	testHugeDensities();
+	return finishTests("SplineTessellatorTests");
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,130 @@
+/**
+ * TexListCacheTests.cpp
+ *
+ * Description:
+ *    Tests texlist sizing and sharing against synthetic texture packs
+ *    written to a temporary mod folder.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "TexListCache.h"
+#include "TestSupport.h"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+// See TexListCache.cpp.
+#define PAK_MAGIC 0x6B617001
+#define PAK_FILE_TABLE_OFFSET 0x39
+
+static void writeInt(std::ofstream& file, int32_t value) {
+	file.write((const char*)&value, sizeof(value));
+}
+
+/* Writes a texture pack whose file table lists the given file names. */
+static void writePak(const std::filesystem::path& path, const std::vector<std::string>& fileNames) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	writeInt(file, PAK_MAGIC);
+	file << std::string(PAK_FILE_TABLE_OFFSET - sizeof(int32_t), '\0');
+	writeInt(file, (int32_t)fileNames.size());
+	for (const std::string& fileName : fileNames) {
+		std::string longPath = "C:\\textures\\" + fileName;
+		writeInt(file, (int32_t)longPath.size());
+		file << longPath;
+		writeInt(file, (int32_t)fileName.size());
+		file << fileName;
+		writeInt(file, 16); // Data length
+		writeInt(file, 16); // Data length again
+	}
+}
+
+static std::vector<std::string> textureNames(int count) {
+	std::vector<std::string> names;
+	for (int i = 0; i < count; i++) {
+		names.push_back("texture" + std::to_string(i) + ".dds");
+	}
+	return names;
+}
+
+static void testReadPakTextureCount(const std::filesystem::path& prsPath) {
+	std::vector<std::string> names = textureNames(3);
+	names.push_back("Level.INF");
+	writePak(prsPath / "small.pak", names);
+	CHECK(TexListCache::readPakTextureCount(prsPath / "small.pak") == 3);
+
+	writePak(prsPath / "empty.pak", {});
+	CHECK(TexListCache::readPakTextureCount(prsPath / "empty.pak") == 0);
+
+	writePak(prsPath / "large.pak", textureNames(600));
+	CHECK(TexListCache::readPakTextureCount(prsPath / "large.pak") == 600);
+
+	{
+		std::ofstream file(prsPath / "notapak.pak", std::ios::binary);
+		file << "This is not a texture pack, but it is long enough to be one.";
+	}
+	CHECK(TexListCache::readPakTextureCount(prsPath / "notapak.pak") == -1);
+
+	// A file table cut short, as by an interrupted download.
+	writePak(prsPath / "truncated.pak", textureNames(10));
+	std::filesystem::resize_file(prsPath / "truncated.pak", PAK_FILE_TABLE_OFFSET + 40);
+	CHECK(TexListCache::readPakTextureCount(prsPath / "truncated.pak") == -1);
+
+	CHECK(TexListCache::readPakTextureCount(prsPath / "missing.pak") == -1);
+}
+
+static void testSharing(const std::filesystem::path& modPath) {
+	AssetIndex assetIndex(modPath.string().c_str());
+	TexListCache texListCache;
+
+	std::shared_ptr<SharedTexList> small = texListCache.get(assetIndex, "small.pak", false);
+	CHECK(small->texList.nbTexture == 3);
+	CHECK(small->texList.textures == small->textureNames.get());
+	CHECK(small->textureName == "small");
+	// Imports naming the same pack share its texlist, whatever the case.
+	CHECK(texListCache.get(assetIndex, "SMALL", false) == small);
+
+	// Levels can't use more than 500 textures.
+	CHECK(texListCache.get(assetIndex, "large.pak", false)->texList.nbTexture == 500);
+	// Unreadable packs get the old fixed size.
+	CHECK(texListCache.get(assetIndex, "notapak.pak", false)->texList.nbTexture == 256);
+	CHECK(texListCache.get(assetIndex, "missing.pak", false)->texList.nbTexture == 256);
+
+	// Once no level uses a texlist, it is freed and made again when needed.
+	std::weak_ptr<SharedTexList> released = small;
+	small.reset();
+	CHECK(released.expired());
+	CHECK(texListCache.get(assetIndex, "small.pak", false)->texList.nbTexture == 3);
+}
+
+int main() {
+	std::filesystem::path modPath =
+		std::filesystem::temp_directory_path() / "TexListCacheTests";
+	std::filesystem::path prsPath = modPath / "gd_PC" / "PRS";
+	std::filesystem::remove_all(modPath);
+	std::filesystem::create_directories(prsPath);
+	testReadPakTextureCount(prsPath);
+	testSharing(modPath);
+	std::filesystem::remove_all(modPath);
+	return finishTests("TexListCacheTests");
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
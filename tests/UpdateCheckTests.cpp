@@ -0,0 +1,299 @@
+/**
+ * UpdateCheckTests.cpp
+ *
+ * Description:
+ *    Runs the update check against a local HTTP stand-in that can answer
+ *    normally, slowly, never, or with a bad version. Counts the requests to
+ *    check that a saved result keeps launches off the network, and that an
+ *    expired one is revalidated with a 304.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "UpdateCheck.h"
+#include "TestSupport.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+#define ETAG "\"v1\""
+#define SLOW_BYTE_DELAY std::chrono::milliseconds(200)
+// How long a cancelled check may take to notice, curl checks about once a
+// second while a transfer is idle.
+#define CANCEL_LIMIT std::chrono::seconds(3)
+
+/* A one connection at a time HTTP server for the version file. */
+class LocalServer {
+	public:
+		enum class Mode {
+			// Answers at once, or with a 304 if the request sends ETAG.
+			Normal,
+			// Sends the body a byte at a time.
+			Slow,
+			// Reads the request and never answers.
+			Hung
+		};
+
+		LocalServer() {
+			listener = socket(AF_INET, SOCK_STREAM, 0);
+			sockaddr_in address = {};
+			address.sin_family = AF_INET;
+			address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			bind(listener, (sockaddr*)&address, sizeof(address));
+			socklen_t addressSize = sizeof(address);
+			getsockname(listener, (sockaddr*)&address, &addressSize);
+			port = ntohs(address.sin_port);
+			listen(listener, 4);
+			thread = std::thread([this]() { run(); });
+		}
+
+		~LocalServer() {
+			stopped = true;
+			thread.join();
+			close(listener);
+		}
+
+		std::string getURL() const {
+			return "http://127.0.0.1:" + std::to_string(port) + "/VERSION.txt";
+		}
+
+		void setResponse(Mode mode, const std::string& body) {
+			std::lock_guard<std::mutex> lock(responseMutex);
+			this->mode = mode;
+			this->body = body;
+		}
+
+		std::atomic<int> requestCount{ 0 };
+		std::atomic<int> notModifiedCount{ 0 };
+
+	private:
+		int listener;
+		int port;
+		std::thread thread;
+		std::atomic<bool> stopped{ false };
+		std::mutex responseMutex;
+		Mode mode = Mode::Normal;
+		std::string body;
+
+		/* Waits for a socket to be readable, giving up if stopped. */
+		bool waitReadable(int socket) {
+			pollfd pollSocket = { socket, POLLIN, 0 };
+			while (!stopped) {
+				if (poll(&pollSocket, 1, 50) > 0) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void run() {
+			while (waitReadable(listener)) {
+				int client = accept(listener, nullptr, nullptr);
+				if (client >= 0) {
+					answer(client);
+					close(client);
+				}
+			}
+		}
+
+		void answer(int client) {
+			std::string request;
+			char buffer[1024];
+			while (request.find("\r\n\r\n") == std::string::npos) {
+				if (!waitReadable(client)) {
+					return;
+				}
+				ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+				if (received <= 0) {
+					return;
+				}
+				request.append(buffer, received);
+			}
+			requestCount++;
+			Mode mode;
+			std::string body;
+			{
+				std::lock_guard<std::mutex> lock(responseMutex);
+				mode = this->mode;
+				body = this->body;
+			}
+			if (mode == Mode::Hung) {
+				// Hold the connection until the client gives up.
+				while (waitReadable(client) && recv(client, buffer, sizeof(buffer), 0) > 0) {}
+				return;
+			}
+			if (request.find("If-None-Match: " ETAG "\r\n") != std::string::npos) {
+				notModifiedCount++;
+				send("HTTP/1.1 304 Not Modified\r\nETag: " ETAG "\r\n"
+					"Connection: close\r\n\r\n", client);
+				return;
+			}
+			send("HTTP/1.1 200 OK\r\nETag: " ETAG "\r\nContent-Length: " +
+				std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n",
+				client);
+			if (mode == Mode::Slow) {
+				for (char c : body) {
+					std::this_thread::sleep_for(SLOW_BYTE_DELAY);
+					send(std::string(1, c), client);
+				}
+			} else {
+				send(body, client);
+			}
+		}
+
+		static void send(const std::string& text, int client) {
+			::send(client, text.data(), text.size(), MSG_NOSIGNAL);
+		}
+};
+
+static void testParseVersion() {
+	float version = 0;
+	CHECK(parseVersion("4.6", version) && version == 4.6f);
+	CHECK(parseVersion(" 4.7\r\n", version) && version == 4.7f);
+	CHECK(!parseVersion("", version));
+	CHECK(!parseVersion("4.7abc", version));
+	CHECK(!parseVersion("4.6.1", version));
+	CHECK(!parseVersion("-1", version));
+	CHECK(!parseVersion("nan", version));
+	CHECK(!parseVersion("<html>404</html>", version));
+	CHECK(version == 4.7f);
+}
+
+static void testCacheFile(const std::string& modPath) {
+	std::string cachePath = modPath + "/cache_round_trip.ini";
+	UpdateCache cache;
+	CHECK(!readUpdateCache(cachePath, cache));
+	cache.latestVersion = 5.25f;
+	cache.checkedAt = 1700000000;
+	cache.eTag = ETAG;
+	cache.lastModified = "Wed, 21 Oct 2015 07:28:00 GMT";
+	writeUpdateCache(cachePath, cache);
+	UpdateCache readCache;
+	CHECK(readUpdateCache(cachePath, readCache));
+	CHECK(readCache.latestVersion == 5.25f);
+	CHECK(readCache.checkedAt == 1700000000);
+	CHECK(readCache.eTag == ETAG);
+	CHECK(readCache.lastModified == cache.lastModified);
+}
+
+static void testCachedChecks(LocalServer& server, const std::string& modPath) {
+	// checkForUpdate joins paths with a backslash, which is only a separator
+	// on Windows; elsewhere it is part of the file name.
+	std::string cachePath = modPath + "\\update_check.ini";
+	server.setResponse(LocalServer::Mode::Normal, "99.0\n");
+	int requestCount = server.requestCount;
+
+	checkForUpdate(modPath, server.getURL());
+	CHECK(server.requestCount == requestCount + 1);
+	UpdateCache cache;
+	CHECK(readUpdateCache(cachePath, cache));
+	CHECK(cache.latestVersion == 99.0f);
+	CHECK(cache.eTag == ETAG);
+	CHECK(std::filesystem::exists(modPath +
+		"\\Mod developers: manually UPDATE to VERSION 99.000000.txt"));
+
+	// Launches within a day of the last check stay off the network.
+	for (int i = 0; i < 10; i++) {
+		checkForUpdate(modPath, server.getURL());
+	}
+	CHECK(server.requestCount == requestCount + 1);
+
+	// An expired result is revalidated, and a 304 keeps the saved version.
+	cache.checkedAt = 0;
+	writeUpdateCache(cachePath, cache);
+	checkForUpdate(modPath, server.getURL());
+	CHECK(server.requestCount == requestCount + 2);
+	CHECK(server.notModifiedCount == 1);
+	UpdateCache revalidated;
+	CHECK(readUpdateCache(cachePath, revalidated));
+	CHECK(revalidated.latestVersion == 99.0f);
+	CHECK(revalidated.checkedAt > 0);
+	checkForUpdate(modPath, server.getURL());
+	CHECK(server.requestCount == requestCount + 2);
+}
+
+static void testBadBodies(LocalServer& server) {
+	std::atomic<bool> cancelled{ false };
+	for (const char* body : { "4.7abc", "", "nan", "<html>404</html>" }) {
+		server.setResponse(LocalServer::Mode::Normal, body);
+		UpdateCache cache;
+		CHECK(!fetchLatestVersion(server.getURL(), false, cache, cancelled));
+		CHECK(cache.latestVersion == 0);
+		CHECK(cache.eTag.empty());
+	}
+}
+
+static void testSlowServer(LocalServer& server) {
+	std::atomic<bool> cancelled{ false };
+	server.setResponse(LocalServer::Mode::Slow, "4.7");
+	UpdateCache cache;
+	CHECK(fetchLatestVersion(server.getURL(), false, cache, cancelled));
+	CHECK(cache.latestVersion == 4.7f);
+}
+
+static void testHungServer(LocalServer& server) {
+	std::atomic<bool> cancelled{ false };
+	std::atomic<bool> finished{ false };
+	server.setResponse(LocalServer::Mode::Hung, "");
+	bool fetched = true;
+	std::thread check([&]() {
+		UpdateCache cache;
+		fetched = fetchLatestVersion(server.getURL(), false, cache, cancelled);
+		finished = true;
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	CHECK(!finished);
+	auto cancelTime = std::chrono::steady_clock::now();
+	cancelled = true;
+	check.join();
+	CHECK(std::chrono::steady_clock::now() - cancelTime < CANCEL_LIMIT);
+	CHECK(!fetched);
+}
+
+int main() {
+	std::filesystem::path tempPath =
+		std::filesystem::temp_directory_path() / "UpdateCheckTests";
+	std::filesystem::remove_all(tempPath);
+	std::filesystem::create_directories(tempPath / "mod");
+	std::string modPath = (tempPath / "mod").string();
+	curl_global_init(CURL_GLOBAL_ALL);
+	{
+		LocalServer server;
+		testParseVersion();
+		testCacheFile(modPath);
+		testCachedChecks(server, modPath);
+		testBadBodies(server);
+		testSlowServer(server);
+		testHungServer(server);
+	}
+	curl_global_cleanup();
+	std::filesystem::remove_all(tempPath);
+	return finishTests("UpdateCheckTests");
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
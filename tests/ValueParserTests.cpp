@@ -0,0 +1,156 @@
+/**
+ * ValueParserTests.cpp
+ *
+ * Description:
+ *    Tests the ini value parsers on well formed and malformed values, and
+ *    replays the fuzz corpus in corpus/value_parser. Built with
+ *    VALUE_PARSER_FUZZER, this file is a libFuzzer target instead, which
+ *    can grow the corpus:
+ *
+ *        ValueParserFuzzer corpus/value_parser
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "ValueParser.h"
+#include "TestSupport.h"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+/*
+  Runs every parser on the text. Whatever the text, parsing must not crash,
+  and parsed numbers must be finite.
+*/
+static void parseEverything(std::string_view text) {
+	ParseResult<float> number = parseFloat(text);
+	CHECK(!number || std::isfinite(number.value));
+	ParseResult<NJS_VECTOR> position = parsePosition(text);
+	CHECK(!position || (std::isfinite(position.value.x)
+		&& std::isfinite(position.value.y) && std::isfinite(position.value.z)));
+	ParseResult<float> deathPlane = parseDeathPlane(text);
+	CHECK(!deathPlane || std::isfinite(deathPlane.value));
+	parseInt(text);
+	parseHex(text);
+	parseBool(text);
+	splitList(text);
+}
+
+#ifdef VALUE_PARSER_FUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+	parseEverything(std::string_view((const char*)data, size));
+	return 0;
+}
+
+#else
+
+static bool hasError(const char* error, const char* expected) {
+	return error != nullptr && std::string(error) == expected;
+}
+
+static void testNumbers() {
+	CHECK(parseInt("42").value == 42);
+	CHECK(parseInt(" +7 ").value == 7);
+	CHECK(parseInt("-13").value == -13);
+	CHECK(hasError(parseInt("12abc").error, "has extra text after the number"));
+	CHECK(hasError(parseInt("").error, "is not a number"));
+	CHECK(hasError(parseInt("99999999999").error, "is out of range"));
+
+	CHECK(parseFloat("1.5").value == 1.5f);
+	CHECK(parseFloat("+2e2").value == 200.0f);
+	CHECK(hasError(parseFloat("1e99").error, "is out of range"));
+	for (const char* nonFinite : { "nan", "NaN", "inf", "-inf", "INFINITY" }) {
+		CHECK(hasError(parseFloat(nonFinite).error, "is not a finite number"));
+	}
+
+	CHECK(parseHex("0x1F").value == 0x1F);
+	CHECK(parseHex("1f").value == 0x1F);
+	CHECK(!parseHex("0x"));
+}
+
+static void testPositions() {
+	ParseResult<NJS_VECTOR> position = parsePosition(" 1, -2.5 ,3e1 ");
+	CHECK(position && position.value.x == 1 && position.value.y == -2.5f
+		&& position.value.z == 30);
+	CHECK(hasError(parsePosition("1,2").error, "is not three comma separated numbers"));
+	CHECK(hasError(parsePosition("1,2,3,4").error, "is not three comma separated numbers"));
+	CHECK(hasError(parsePosition("1,,3").error, "is not a number"));
+	CHECK(hasError(parsePosition("0,nan,0").error, "is not a finite number"));
+}
+
+static void testWords() {
+	CHECK(parseDeathPlane("-200").value == -200);
+	CHECK(parseDeathPlane("Off").value == DISABLED_PLANE);
+	CHECK(parseDeathPlane(" FALSE ").value == DISABLED_PLANE);
+	CHECK(!parseDeathPlane("inf"));
+
+	CHECK(parseBool("Yes").value);
+	CHECK(parseBool("on").value);
+	CHECK(parseBool("0") && !parseBool("0").value);
+	CHECK(hasError(parseBool("maybe").error, "is not true or false"));
+
+	std::vector<std::string> items = splitList(" a, ,b ,");
+	CHECK(items.size() == 2 && items[0] == "a" && items[1] == "b");
+
+	std::string message = describeParseError("level_id", "abc", parseInt("abc").error);
+	CHECK(message.find("level_id") != std::string::npos);
+	CHECK(message.find("\"abc\"") != std::string::npos);
+}
+
+static void testNoAllocations() {
+	size_t allocationCount = getAllocationCount();
+	for (int i = 0; i < 1000; i++) {
+		parseInt("12345");
+		parseFloat("-1.25e3");
+		parsePosition("1, 2, 3");
+		parsePosition("1, 2");
+		parseDeathPlane("off");
+		parseHex("0xFFFF");
+		parseBool("true");
+	}
+	CHECK(getAllocationCount() == allocationCount);
+}
+
+static void testCorpus() {
+	size_t inputCount = 0;
+	for (const auto& file : std::filesystem::directory_iterator(getCorpusPath("value_parser"))) {
+		std::ifstream stream(file.path(), std::ios::binary);
+		std::string text((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+		parseEverything(text);
+		inputCount++;
+	}
+	CHECK(inputCount > 0);
+}
+
+int main() {
+	testNumbers();
+	testPositions();
+	testWords();
+	testNoAllocations();
+	testCorpus();
+	return finishTests("ValueParserTests");
+}
+
+#endif
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
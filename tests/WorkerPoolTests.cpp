@@ -0,0 +1,218 @@
+/**
+ * WorkerPoolTests.cpp
+ *
+ * Description:
+ *    Tests that WorkerPool runs every job once, passes the first exception
+ *    back to the caller, and can be shared by nested and concurrent
+ *    callers. Checks that readSplines lists splines in the same order
+ *    whatever the thread count, and prints its time across file and thread
+ *    counts.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "pch.h"
+#include "AssetIndex.h"
+#include "IniReader.h"
+#include "LevelArena.h"
+#include "SplinePool.h"
+#include "TestSupport.h"
+#include "WorkerPool.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define MAX_SPLINE_FILES 500
+#define POINTS_PER_SPLINE 20
+#define CALLER_COUNT 4
+#define RUNS_PER_CALLER 100
+
+static const size_t THREAD_COUNTS[] = { 0, 1, 3, 7 };
+
+static void testEveryJobOnce() {
+	for (size_t threadCount : THREAD_COUNTS) {
+		WorkerPool workerPool(threadCount);
+		CHECK(workerPool.getThreadCount() == threadCount);
+		for (size_t count : { 0, 1, 2, 7, 1000 }) {
+			std::vector<std::atomic<int>> runs(count);
+			workerPool.run(count, [&runs](size_t i) { runs[i]++; });
+			bool ranOnce = true;
+			for (const std::atomic<int>& run : runs) {
+				ranOnce = ranOnce && run == 1;
+			}
+			CHECK(ranOnce);
+		}
+	}
+}
+
+static void testExceptions() {
+	WorkerPool workerPool(3);
+	std::atomic<int> started{ 0 };
+	bool caught = false;
+	try {
+		workerPool.run(200, [&started](size_t i) {
+			started++;
+			if (i == 0) {
+				throw std::runtime_error("job 0 failed");
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		});
+	} catch (const std::runtime_error& error) {
+		caught = std::string(error.what()) == "job 0 failed";
+	}
+	CHECK(caught);
+	// Jobs that had not started when job 0 failed were skipped.
+	CHECK(started < 200);
+
+	// Only the first exception is passed on, after every job is done.
+	std::atomic<int> finished{ 0 };
+	caught = false;
+	try {
+		workerPool.run(100, [&finished](size_t i) {
+			finished++;
+			throw std::runtime_error("failed");
+		});
+	} catch (const std::runtime_error&) {
+		caught = true;
+	}
+	CHECK(caught);
+	CHECK(finished >= 1);
+
+	// A single job runs on the caller, and throws the same way.
+	caught = false;
+	try {
+		workerPool.run(1, [](size_t) { throw std::logic_error("single"); });
+	} catch (const std::logic_error&) {
+		caught = true;
+	}
+	CHECK(caught);
+
+	// The pool is still usable afterwards.
+	std::atomic<int> runs{ 0 };
+	workerPool.run(100, [&runs](size_t) { runs++; });
+	CHECK(runs == 100);
+}
+
+static void testSharedPool() {
+	WorkerPool workerPool(2);
+	// A job can run jobs of its own on the pool it is running on.
+	std::atomic<int> innerRuns{ 0 };
+	workerPool.run(8, [&](size_t) {
+		workerPool.run(8, [&innerRuns](size_t) { innerRuns++; });
+	});
+	CHECK(innerRuns == 64);
+
+	// Several threads can use the pool at once, as the preloader and the
+	// level load hook do.
+	std::atomic<size_t> total{ 0 };
+	std::vector<std::thread> callers;
+	for (int caller = 0; caller < CALLER_COUNT; caller++) {
+		callers.emplace_back([&workerPool, &total]() {
+			for (int run = 0; run < RUNS_PER_CALLER; run++) {
+				workerPool.run(50, [&total](size_t i) { total += i; });
+			}
+		});
+	}
+	for (std::thread& caller : callers) {
+		caller.join();
+	}
+	CHECK(total == CALLER_COUNT * RUNS_PER_CALLER * (49 * 50 / 2));
+}
+
+/* A mod folder of spline files, each with a Code equal to its number. */
+static void makeModFolder(const std::filesystem::path& modPath) {
+	std::filesystem::create_directories(modPath / "gd_PC" / "Paths");
+	for (int i = 0; i < MAX_SPLINE_FILES; i++) {
+		std::ofstream file(modPath / "gd_PC" / "Paths" /
+			("rail" + std::to_string(i) + ".ini"), std::ios::binary);
+		file << "Code=" << std::hex << i << std::dec << "\n";
+		for (int point = 0; point < POINTS_PER_SPLINE; point++) {
+			file << "[" << point << "]\nPosition=" << i << ", " << point << ", 0\n";
+		}
+	}
+}
+
+/* Reads the first fileCount splines, returning their codes in array order. */
+static std::vector<uintptr_t> readSplines(IniReader& iniReader, size_t fileCount,
+		size_t threadCount) {
+	std::vector<std::string> splineFileNames;
+	for (size_t i = 0; i < fileCount; i++) {
+		splineFileNames.push_back("rail" + std::to_string(i));
+	}
+	WorkerPool workerPool(threadCount);
+	// A new pool each time, so every file is parsed again.
+	SplinePool splinePool;
+	LevelArena arena;
+	std::vector<std::shared_ptr<SharedSpline>> sharedSplines;
+	LoopHead** splines = iniReader.readSplines(splineFileNames, false, arena,
+		workerPool, splinePool, sharedSplines, false);
+	std::vector<uintptr_t> codes;
+	for (size_t i = 0; splines != nullptr && splines[i] != nullptr; i++) {
+		codes.push_back((uintptr_t)splines[i]->Object);
+	}
+	return codes;
+}
+
+static void testSplineOrder(const std::filesystem::path& modPath) {
+	AssetIndex assetIndex(modPath.string().c_str());
+	IniReader iniReader(modPath.string().c_str(), assetIndex);
+	// Splines are listed in the order the index found their files.
+	std::vector<uintptr_t> expectedCodes;
+	for (const AssetEntry* file : assetIndex.findAll(AssetFolder::Paths, "ini")) {
+		expectedCodes.push_back(std::stoi(file->stem.substr(4)));
+	}
+	CHECK(expectedCodes.size() == MAX_SPLINE_FILES);
+	for (size_t threadCount : THREAD_COUNTS) {
+		CHECK(readSplines(iniReader, MAX_SPLINE_FILES, threadCount) == expectedCodes);
+	}
+
+	for (size_t fileCount : { 1, 10, 100, 500 }) {
+		for (size_t threadCount : THREAD_COUNTS) {
+			auto start = std::chrono::steady_clock::now();
+			std::vector<uintptr_t> codes = readSplines(iniReader, fileCount, threadCount);
+			double time = std::chrono::duration<double, std::milli>(
+				std::chrono::steady_clock::now() - start).count();
+			CHECK(codes.size() == fileCount);
+			std::printf("%zu spline file(s) on %zu pool thread(s): %.2f ms\n",
+				fileCount, threadCount, time);
+		}
+	}
+}
+
+int main() {
+	std::filesystem::path modPath =
+		std::filesystem::temp_directory_path() / "WorkerPoolTests";
+	std::filesystem::remove_all(modPath);
+	makeModFolder(modPath);
+	testEveryJobOnce();
+	testExceptions();
+	testSharedPool();
+	testSplineOrder(modPath);
+	std::filesystem::remove_all(modPath);
+	return finishTests("WorkerPoolTests");
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
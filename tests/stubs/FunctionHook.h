@@ -0,0 +1,10 @@
+#pragma once
+
+/* Declares the mod loader's FunctionHook, which the tests never install. */
+template <typename ReturnType, typename... Arguments>
+class FunctionHook {
+	public:
+		typedef ReturnType(*FunctionType)(Arguments...);
+		FunctionHook(FunctionType original, FunctionType hook);
+		ReturnType Original(Arguments... arguments);
+};
@@ -0,0 +1,13 @@
+#pragma once
+#include <istream>
+#include <string>
+
+/* Declares the mod loader's LandTableInfo, which the tests never load. */
+class LandTableInfo {
+	public:
+		LandTableInfo(const char* fileName);
+		LandTableInfo(const std::string& fileName);
+		LandTableInfo(std::istream& stream);
+		~LandTableInfo();
+		LandTable* getlandtable();
+};
@@ -0,0 +1,71 @@
+#pragma once
+/*
+  The parts of the mod loader's SA2ModLoader.h used by the sources under test,
+  with the same layouts, so the tests build without the game's SDK.
+*/
+#include <windows.h>
+#include <cstdint>
+#include <map>
+#include <string>
+
+enum LevelIDs {
+	LevelIDs_BasicTest,
+	LevelIDs_GreenForest = 13,
+	LevelIDs_ChaoWorld = 90,
+	LevelIDs_Invalid = 91
+};
+
+struct NJS_VECTOR {
+	float x, y, z;
+};
+
+struct NJS_TEXNAME {
+	void* filename;
+	uint32_t attr;
+	uint32_t texaddr;
+};
+
+struct NJS_TEXLIST {
+	NJS_TEXNAME* textures;
+	uint32_t nbTexture;
+};
+
+struct LandTable {
+	int16_t COLCount;
+	int16_t ChunkModelCount;
+	int16_t field_4[6];
+	float field_10;
+	void* COLList;
+	void* AnimationList;
+	const char* TextureName;
+	NJS_TEXLIST* TextureList;
+};
+
+typedef void(__cdecl* ObjectFuncPtr)(void*);
+
+struct LoopPoint {
+	int16_t XRot;
+	int16_t YRot;
+	float Distance;
+	NJS_VECTOR Position;
+};
+
+struct LoopHead {
+	int16_t anonymous_0;
+	int16_t Count;
+	float TotalDistance;
+	LoopPoint* Points;
+	ObjectFuncPtr Object;
+};
+
+struct StartPosition {
+	short Level;
+	int16_t Rotation1P;
+	int16_t RotationP1;
+	int16_t RotationP2;
+	NJS_VECTOR Position1P;
+	NJS_VECTOR PositionP1;
+	NJS_VECTOR PositionP2;
+};
+
+void PrintDebug(const char* format, ...);
@@ -0,0 +1,51 @@
+#pragma once
+/*
+  The Windows API used by the sources under test, for building the tests on
+  other systems. The file functions are implemented with POSIX calls in
+  support/PosixWindows.cpp.
+*/
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+typedef int BOOL;
+typedef unsigned char boolean;
+typedef unsigned long DWORD;
+typedef long long LONGLONG;
+typedef void* HANDLE;
+typedef void* HMODULE;
+typedef union {
+	struct {
+		DWORD LowPart;
+		long HighPart;
+	};
+	LONGLONG QuadPart;
+} LARGE_INTEGER;
+
+#define __cdecl
+#define INVALID_HANDLE_VALUE ((HANDLE)(intptr_t)-1)
+#define GENERIC_READ 0x80000000
+#define FILE_SHARE_READ 0x1
+#define OPEN_EXISTING 3
+#define FILE_FLAG_SEQUENTIAL_SCAN 0x08000000
+#define PAGE_READONLY 0x02
+#define PAGE_WRITECOPY 0x08
+#define FILE_MAP_COPY 0x1
+#define FILE_MAP_READ 0x4
+#define MB_OK 0x0
+#define MB_ICONWARNING 0x30
+
+HANDLE CreateFileW(const wchar_t* fileName, DWORD access, DWORD shareMode,
+	void* security, DWORD creation, DWORD flags, HANDLE templateFile);
+BOOL GetFileSizeEx(HANDLE file, LARGE_INTEGER* size);
+HANDLE CreateFileMappingA(HANDLE file, void* security, DWORD protect,
+	DWORD sizeHigh, DWORD sizeLow, const char* name);
+void* MapViewOfFile(HANDLE mapping, DWORD access, DWORD offsetHigh,
+	DWORD offsetLow, size_t size);
+BOOL UnmapViewOfFile(const void* view);
+BOOL CloseHandle(HANDLE handle);
+int MessageBoxA(void* owner, const char* text, const char* caption, unsigned type);
+
+inline char* _strdup(const char* text) {
+	return strdup(text);
+}
@@ -0,0 +1,103 @@
+/**
+ * PosixWindows.cpp
+ *
+ * Description:
+ *    The Windows file mapping calls used by MappedFile, implemented with
+ *    POSIX calls so the tests run the real MappedFile on other systems.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include <windows.h>
+#include <fcntl.h>
+#include <filesystem>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+/* A file or file mapping handle. Mappings share their file's descriptor. */
+struct PosixHandle {
+	int fd;
+	bool isMapping;
+	bool copyOnWrite;
+};
+
+// Views are unmapped by address, so their sizes are kept here. Buckets are
+// made up front, so mapping files leaves no allocations behind.
+static std::mutex viewMutex;
+static std::unordered_map<const void*, size_t> viewSizes(64);
+
+static size_t getFileSize(int fd) {
+	struct stat status;
+	return fstat(fd, &status) == 0 ? (size_t)status.st_size : 0;
+}
+
+HANDLE CreateFileW(const wchar_t* fileName, DWORD, DWORD, void*, DWORD, DWORD, HANDLE) {
+	int fd = open(std::filesystem::path(fileName).string().c_str(), O_RDONLY);
+	if (fd == -1) {
+		return INVALID_HANDLE_VALUE;
+	}
+	return new PosixHandle{ fd, false, false };
+}
+
+BOOL GetFileSizeEx(HANDLE file, LARGE_INTEGER* size) {
+	size->QuadPart = (LONGLONG)getFileSize(((PosixHandle*)file)->fd);
+	return 1;
+}
+
+HANDLE CreateFileMappingA(HANDLE file, void*, DWORD protect, DWORD, DWORD, const char*) {
+	return new PosixHandle{ ((PosixHandle*)file)->fd, true, protect == PAGE_WRITECOPY };
+}
+
+void* MapViewOfFile(HANDLE mapping, DWORD, DWORD, DWORD, size_t) {
+	PosixHandle* handle = (PosixHandle*)mapping;
+	size_t size = getFileSize(handle->fd);
+	void* view = mmap(nullptr, size, handle->copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ,
+		MAP_PRIVATE, handle->fd, 0);
+	if (view == MAP_FAILED) {
+		return nullptr;
+	}
+	std::lock_guard<std::mutex> lock(viewMutex);
+	viewSizes[view] = size;
+	return view;
+}
+
+BOOL UnmapViewOfFile(const void* view) {
+	std::lock_guard<std::mutex> lock(viewMutex);
+	munmap(const_cast<void*>(view), viewSizes[view]);
+	viewSizes.erase(view);
+	return 1;
+}
+
+BOOL CloseHandle(HANDLE handle) {
+	PosixHandle* posixHandle = (PosixHandle*)handle;
+	if (!posixHandle->isMapping) {
+		close(posixHandle->fd);
+	}
+	delete posixHandle;
+	return 1;
+}
+
+int MessageBoxA(void*, const char*, const char*, unsigned) {
+	return 1; // IDOK
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
@@ -0,0 +1,98 @@
+/**
+ * TestSupport.cpp
+ *
+ * Description:
+ *    Checks, allocation counting and mod loader stand-ins shared by the
+ *    tests.
+ *
+ *    X-Hax discord for code questions: https://discord.gg/gqJCF47
+ */
+
+#include "TestSupport.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+static int failedCount = 0;
+static thread_local size_t allocationCount = 0;
+static thread_local size_t deleteCount = 0;
+
+void checkCondition(bool passed, const char* expression, const char* file, int line) {
+	if (!passed) {
+		std::printf("%s:%d: check failed: %s\n", file, line, expression);
+		failedCount++;
+	}
+}
+
+int finishTests(const char* testName) {
+	std::printf("%s: %s (%d failed check(s))\n", testName,
+		failedCount == 0 ? "passed" : "FAILED", failedCount);
+	return failedCount == 0 ? 0 : 1;
+}
+
+size_t getAllocationCount() {
+	return allocationCount;
+}
+
+size_t getLiveAllocationCount() {
+	return allocationCount - deleteCount;
+}
+
+std::string getCorpusPath(const std::string& fileName) {
+	return std::string(TEST_CORPUS_PATH) + "/" + fileName;
+}
+
+// A fixed buffer, so logging never shows up in allocation counts.
+static thread_local char lastDebugMessage[1024];
+
+void PrintDebug(const char* format, ...) {
+	// Only shown when a test fails, through ctest --output-on-failure.
+	va_list arguments;
+	va_start(arguments, format);
+	std::vsnprintf(lastDebugMessage, sizeof(lastDebugMessage), format, arguments);
+	va_end(arguments);
+	std::printf("%s\n", lastDebugMessage);
+}
+
+std::string getLastDebugMessage() {
+	return lastDebugMessage;
+}
+
+void* operator new(size_t size) {
+	allocationCount++;
+	void* memory = std::malloc(size == 0 ? 1 : size);
+	if (memory == nullptr) {
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void operator delete(void* memory) noexcept {
+	if (memory != nullptr) {
+		deleteCount++;
+	}
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+	operator delete(memory);
+}
+
+
+
+/*************************************************************************
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *	https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *************************************************************************/
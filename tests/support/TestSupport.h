@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+/*
+  Records a failed check, with its expression and line, without stopping the
+  test so every failure of a run is reported.
+*/
+#define CHECK(condition) \
+	checkCondition((condition), #condition, __FILE__, __LINE__)
+
+void checkCondition(
+	bool passed,
+	const char* expression,
+	const char* file,
+	int line
+);
+
+/* Prints a summary and returns the test's exit code. */
+int finishTests(const char* testName);
+
+/* The number of global operator new calls made by this thread so far. */
+size_t getAllocationCount();
+
+/* The number of this thread's operator new calls not yet deleted. */
+size_t getLiveAllocationCount();
+
+/* The last message this thread logged through the mod loader. */
+std::string getLastDebugMessage();
+
+/* The path of a file in the tests' corpus folder. */
+std::string getCorpusPath(const std::string& fileName);